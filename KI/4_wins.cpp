@@ -8,9 +8,14 @@
 #include "CustomDefines.h"
 #include "Field.h"
 #include "Algorithm.h"
+#include "Tools.h"
 
-int main(void)
+int main(int argc, char* argv[])
 {
+    // With arguments one of the command line tools runs instead of the game.
+    if (argc > 1)
+        return runTool(argc, argv);
+
     // Create a GameMaster to initialize the game
     GameMaster gameMaster;
     Field::Player nextTurnBy = Field::Player::Human;
@@ -1,8 +1,104 @@
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
 #include "Algorithm.h"
-#include <omp.h>
+#include "PerfCounters.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+
+// Maximum number of retired trees that wait for the reclaimer thread. If it falls behind, the searches free their
+// trees themselves. See Algorithm::setMemoryBudget for the memory this takes beyond the budget.
+constexpr size_t MAX_RETIRED_TREES = 1;
+
+// The evaluation cache of an instance gets this fraction of its memory budget, 2 MB of the default budget.
+constexpr size_t EVALUATION_CACHE_BUDGET_SHARE = 64;
+// The table of the proof-number search gets this fraction of the memory budget, 4 MB of the default budget.
+constexpr size_t PROOF_NUMBER_BUDGET_SHARE = 32;
+
+// The proof-number search before the minimax search gets at most this fraction of the time budget and is skipped if
+// less than PROOF_MIN_TIME_BUDGET_MS are left.
+constexpr int PROOF_TIME_SHARE = 4;
+constexpr int PROOF_MIN_TIME_BUDGET_MS = 4;
+
+/**
+ * Helper function to count all nodes below a node.
+ *
+ * \param node The node whose descendants are counted.
+ * \return Returns the number of descendants.
+ */
+static size_t countDescendants(const std::shared_ptr<Node>& node)
+{
+    size_t count = 0;
+    std::vector<Node*> pending = { node.get() };
+    while (!pending.empty())
+    {
+        Node* current = pending.back();
+        pending.pop_back();
+        for (const std::shared_ptr<Node>& child : current->getChildren())
+        {
+            count++;
+            pending.push_back(child.get());
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Helper function to put the children of a node into search order. The move from the transposition table comes first,
+ * the others follow from the center column outwards.
+ *
+ * \param children The children in the order of their columns.
+ * \param firstMove The column that is searched first, -1 if there is none.
+ * \param ordered Receives pointers to the children in search order.
+ * \return Returns the number of children.
+ */
+static int orderChildren(const std::vector<std::shared_ptr<Node>>& children, int firstMove,
+    const std::shared_ptr<Node>* ordered[FIELD_WIDTH])
+{
+    int count = 0;
+    for (const std::shared_ptr<Node>& child : children)
+        ordered[count++] = &child;
+
+    auto rank = [firstMove](const std::shared_ptr<Node>* child) {
+        int move = (*child)->getMoveMade();
+        return move == firstMove ? -1 : std::abs(2 * move - FIELD_WIDTH - 1);
+    };
+    std::stable_sort(ordered, ordered + count, [&rank](const std::shared_ptr<Node>* first,
+        const std::shared_ptr<Node>* second) {
+        return rank(first) < rank(second);
+    });
+
+    return count;
+}
 
 /**
- * Private constructor to prevent instancing. This class is designed using the singleton pattern.
+ * Helper function to free a tree that is no longer needed on a background thread. A tree of the full depth has
+ * hundreds of thousands of nodes, freeing them would delay the next move.
+ * The engine library (C4_BUILD_LIBRARY) frees the tree right away instead. A library can be unloaded while its thread
+ * is still freeing a tree, and joining the thread during the unload can dead lock.
+ *
+ * \param tree The tree. The caller must not hold other references to it.
+ */
+static void retireTree(std::shared_ptr<Node> tree)
+{
+#ifdef C4_BUILD_LIBRARY
+    tree.reset();
+#else
+    // Destroyed at exit like every other static, which frees the queued trees and joins the thread.
+    static ThreadPool reclaimer(1, MAX_RETIRED_TREES);
+    if (!tree)
+        return;
+
+    // If the queue is full, the rejected task and with it the tree are freed right here.
+    reclaimer.submit([tree = std::move(tree)]() mutable { tree.reset(); });
+#endif
+}
+
+/**
+ * Public constructor. The console game uses the shared instance from Algorithm::getInstance. Everything that runs
+ * several searches at the same time (e.g. the GameServer) needs one instance per running search.
  *
  */
 Algorithm::Algorithm()
@@ -11,9 +107,9 @@ Algorithm::Algorithm()
 }
 
 /**
- * Static getter for the instance of this singleton class.
+ * Static getter for the shared instance of this class.
  *
- * \return Instance of the singleton class.
+ * \return Instance of the class.
  */
 Algorithm* Algorithm::getInstance()
 {
@@ -21,30 +117,509 @@ Algorithm* Algorithm::getInstance()
     return &instance;
 }
 
+/**
+ * Getter for the name of the engine.
+ *
+ * \return Returns the name used by Engine::create.
+ */
+std::string Algorithm::name()
+{
+    return "minimax";
+}
+
+/**
+ * Sets the transposition table the search uses. The same table can be shared by several instances, even if they
+ * search at the same time.
+ *
+ * \param table The table to use. nullptr disables the transposition table.
+ */
+void Algorithm::setTranspositionTable(std::shared_ptr<TranspositionTable> table)
+{
+    m_transpositionTable = table;
+}
+
+/**
+ * Limits the memory of the instance. The table of the proof-number search and the evaluation cache of the instance get
+ * a share of the budget, unless the cache was set by Algorithm::setEvaluationCache. The tree gets the rest. The tables
+ * are created right away, so the first search does not have to. The tree keeps its upper levels up to its
+ * share. Deeper levels are still searched, but they are freed as soon as their parent is evaluated, so they have to be
+ * created again by the next depth. The transposition table is not part of this budget, it is sized by whoever creates
+ * it.
+ * Outside of the engine library, the tree of the previous move is freed on a background thread shared by all
+ * instances, see MAX_RETIRED_TREES. That thread holds one tree it is freeing and one waiting tree, so the process can
+ * use up to two trees more than the budgets of its instances.
+ *
+ * \param megabytes The memory budget in MB.
+ */
+void Algorithm::setMemoryBudget(size_t megabytes)
+{
+    // The tables are created again with their new size.
+    if (megabytes != m_memoryBudgetMb)
+    {
+        m_proofNumberSearch.reset();
+        if (!m_sharedEvaluationCache)
+            m_evaluationCache.reset();
+    }
+
+    m_memoryBudgetMb = megabytes;
+    allocateTables();
+}
+
+/**
+ * Sets the cache of leaf evaluations. Instances without one create a cache of their own when it is first needed. The
+ * same cache can be shared by several instances, even if they search at the same time.
+ *
+ * \param cache The cache to use. nullptr disables the cache.
+ */
+void Algorithm::setEvaluationCache(std::shared_ptr<EvaluationCache> cache)
+{
+    m_evaluationCache = cache;
+    m_sharedEvaluationCache = true;
+}
+
+/**
+ * Getter for the cache of leaf evaluations, e.g. to clear it.
+ *
+ * \return Returns the cache. nullptr if it is disabled.
+ */
+std::shared_ptr<EvaluationCache> Algorithm::getEvaluationCache()
+{
+    allocateTables();
+    return m_evaluationCache;
+}
+
+/**
+ * Helper method to split the memory budget and to create the tables of the instance that were not created yet. They
+ * are not created by the constructor, because most users replace them or change the budget right away.
+ *
+ */
+void Algorithm::allocateTables()
+{
+    size_t budget = m_memoryBudgetMb * 1024 * 1024;
+    size_t cacheBudget = budget / EVALUATION_CACHE_BUDGET_SHARE;
+    size_t proofBudget = budget / PROOF_NUMBER_BUDGET_SHARE;
+    if (!m_evaluationCache && !m_sharedEvaluationCache)
+        m_evaluationCache = std::make_shared<EvaluationCache>(EvaluationCache::entriesForBudget(cacheBudget));
+    if (!m_proofNumberSearch)
+        m_proofNumberSearch = std::make_unique<ProofNumberSearch>(ProofNumberSearch::entriesForBudget(proofBudget));
+
+    m_maxNodes = std::max<size_t>((budget - cacheBudget - proofBudget) / NODE_MEMORY_ESTIMATE, 1);
+}
+
+/**
+ * Limits the proof-number search that runs before the minimax search. A forced win it proves is played right away,
+ * no matter how deep it is. The search does not run for Algorithm::analyze, because that needs the values of all
+ * moves. With a time budget it also stops after a quarter of the budget or when the search is cancelled.
+ *
+ * \param nodes The maximum number of nodes of the proof-number search. 0 disables it.
+ */
+void Algorithm::setProofNodeBudget(uint64_t nodes)
+{
+    m_proofNodeBudget = nodes;
+}
+
+/**
+ * Configures the selective depth control of the minimax search. Extensions make the search deeper than its nominal
+ * depth along forcing lines, reductions make it shallower for quiet moves that are unlikely to be the best.
+ *
+ * \param selectiveSearch The configuration, see SelectiveSearch.
+ */
+void Algorithm::setSelectiveSearch(const SelectiveSearch& selectiveSearch)
+{
+    m_selectiveSearch = selectiveSearch;
+    m_selectiveSearch.maxExtensions = std::max(m_selectiveSearch.maxExtensions, 0);
+    m_selectiveSearch.reductionMoveIndex = std::max(m_selectiveSearch.reductionMoveIndex, 1);
+    m_selectiveSearch.reduction = std::max(m_selectiveSearch.reduction, 1);
+}
+
 /**
  * Calculates the next move the algorithm wants to make.
  *
  * \param field The field that is used as the top node of the tree. The algorithm will calculate its next move on the
  * basis of that field.
+ * \param timeBudgetMs The time the search may take in milliseconds. The tree is deepened one level at a time until
+ * the budget runs out, but a search of depth 1 is always completed. 0 means, that there is no limit.
  * \return The number of the column in which the algorithm wants make its next move. This starts at 1 because it mimics
  *  a human player.
  */
-int Algorithm::getNextMove(Field field)
+int Algorithm::getNextMove(Field field, int timeBudgetMs)
+{
+    return search(field, timeBudgetMs, nullptr, nullptr);
+}
+
+/**
+ * Calculates the next move the algorithm wants to make in the background. The search deepens the tree one level at a
+ * time and can be cancelled at any point, see SearchHandle. Only one search per instance may run at a time and the
+ * instance has to outlive the handle.
+ *
+ * \param field The field that is used as the top node of the tree.
+ * \param progress Is called on the searching thread after every completed depth. Can be nullptr.
+ * \param timeBudgetMs The time the search may take in milliseconds. 0 means, that there is no limit.
+ * \return Returns the handle of the search.
+ */
+SearchHandle Algorithm::getNextMoveAsync(Field field, ProgressCallback progress, int timeBudgetMs)
 {
-    // Create the tree
+    std::shared_ptr<std::atomic<bool>> cancelToken = std::make_shared<std::atomic<bool>>(false);
+    std::shared_future<int> result = std::async(std::launch::async, [this, field, progress, timeBudgetMs,
+        cancelToken]() {
+        return search(field, timeBudgetMs, progress, cancelToken);
+    }).share();
+
+    return SearchHandle(result, cancelToken);
+}
+
+/**
+ * Evaluates all root moves instead of only the best one. This is much cheaper than a search per move, because the
+ * moves share the tree and the transposition table.
+ *
+ * \param field The field that is used as the top node of the tree.
+ * \param topMoves The number of best moves that get an exact value. The others are left out. 0 means, that all moves
+ * get an exact value.
+ * \param timeBudgetMs The time the analysis may take in milliseconds. The result is that of the last completed depth.
+ * 0 means, that there is no limit.
+ * \return Returns the analysis of the moves, sorted from the best to the worst.
+ */
+std::vector<MoveAnalysis> Algorithm::analyze(Field field, int topMoves, int timeBudgetMs)
+{
+    std::vector<MoveAnalysis> analysis;
+    search(field, timeBudgetMs, nullptr, nullptr, &analysis, topMoves);
+    return analysis;
+}
+
+/**
+ * Gives info about the work of the last search.
+ *
+ * \return Returns the number of positions minimax visited, counted again for every depth, and those of the
+ * proof-number search.
+ */
+uint64_t Algorithm::getSearchedNodes()
+{
+    return m_searchedNodes;
+}
+
+/**
+ * Gives info about the work of the proof-number search of the last search.
+ *
+ * \return Returns the number of positions the proof-number search visited. They are part of
+ * Algorithm::getSearchedNodes.
+ */
+uint64_t Algorithm::getProofNodes()
+{
+    return m_proofNodes;
+}
+
+/**
+ * Gives info about the depth of the last search.
+ *
+ * \return Returns the deepest depth the last search completed.
+ */
+int Algorithm::getCompletedDepth()
+{
+    return m_completedDepth;
+}
+
+/**
+ * Gives info about the result of the last search.
+ *
+ * \return Returns the value of the move the last search returned, seen from the algorithm like Node::getNodeValue.
+ */
+int Algorithm::getBestValue()
+{
+    return m_bestValue;
+}
+
+/**
+ * Gives info about the selective depth control of the last search.
+ *
+ * \return Returns the extensions, reductions, re-searches and lost moves of all depths of the last search.
+ */
+SelectiveStatistics Algorithm::getSelectiveStatistics()
+{
+    return m_selectiveStatistics;
+}
+
+/**
+ * Gives info about the lookups in the evaluation cache of the last search. Instances that share a cache count their
+ * own lookups, so the statistics of all of them have to be added up for the whole cache.
+ *
+ * \return Returns the hits and misses of the last search.
+ */
+EvaluationCache::Statistics Algorithm::getEvaluationStatistics()
+{
+    return m_evaluationStatistics;
+}
+
+/**
+ * Runs a search. See Algorithm::getNextMove.
+ *
+ * \param field The field that is used as the top node of the tree.
+ * \param timeBudgetMs The time the search may take in milliseconds. 0 means, that there is no limit.
+ * \param progress Is called after every completed depth. Can be nullptr.
+ * \param cancelToken The search stops as soon as the token is set. Can be nullptr.
+ * \param analysis Receives the analysis of the root moves of the last completed depth, see Algorithm::analyze.
+ * nullptr if only the best move is needed.
+ * \param topMoves The number of root moves that need an exact value. 0 means all of them.
+ * \return The number of the column in which the algorithm wants make its next move.
+ */
+int Algorithm::search(Field field, int timeBudgetMs, ProgressCallback progress,
+    std::shared_ptr<std::atomic<bool>> cancelToken, std::vector<MoveAnalysis>* analysis, int topMoves)
+{
+    TRACE_SCOPE("getNextMove");
+    allocateTables();
+
+    // Create the tree. Its levels are created by minimax when they are reached. The tree of the last search is freed
+    // in the background.
+    {
+        TRACE_SCOPE("retireTree");
+        retireTree(std::move(m_topLevelNode));
+    }
     m_topLevelNode.reset(new Node());
     m_topLevelNode->init(field, Field::Player::Human);
-    m_topLevelNode->createNextMoves(TREE_DEPTH);
+    m_nodeCount = 1;
+    m_searchedNodes = 0;
+    m_proofNodes = 0;
+    m_selectiveStatistics = SelectiveStatistics();
+    m_evaluationStatistics = EvaluationCache::Statistics();
+    m_completedDepth = 0;
+    m_bestValue = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    m_deadline = start + std::chrono::milliseconds(timeBudgetMs);
+    m_deadlineEnabled = timeBudgetMs > 0;
+    m_cancelToken = cancelToken;
+    m_stopEnabled = false;
+    m_stopped = false;
+
+    // Without a way to stop the search early the tree is evaluated at its full depth right away. Only the best root
+    // moves need exact values, so they profit from being ordered by the previous depth.
+    bool iterative = m_deadlineEnabled || cancelToken || progress || (analysis && topMoves > 0);
+    int moveToMake = -1;
+    if (!analysis && findForcedWin(field, moveToMake))
+    {
+        if (progress)
+        {
+            SearchProgress snapshot;
+            snapshot.depth = m_completedDepth;
+            snapshot.bestMove = moveToMake;
+            snapshot.bestValue = INT_MAX;
+            snapshot.elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            progress(snapshot);
+        }
+
+        m_cancelToken.reset();
+        return moveToMake;
+    }
+
+    std::vector<MoveAnalysis> depthAnalysis;
+    for (int depth = iterative ? 1 : TREE_DEPTH; depth <= TREE_DEPTH; depth++)
+    {
+        // Evaluate tree
+        m_searchDepth = depth;
+        if (analysis)
+            analyzeRoot(depth, topMoves, depthAnalysis);
+        else
+            minimax(m_topLevelNode, depth, INT_MIN, INT_MAX, Field::Player::Algorithm, 0);
+
+        // The values of an interrupted depth are incomplete, the last completed depth is used instead.
+        if (m_stopped)
+            break;
+
+        moveToMake = getBestChildMove();
+        m_completedDepth = depth;
+        m_bestValue = m_topLevelNode->getNodeValue();
+        if (analysis)
+            *analysis = depthAnalysis;
+        m_stopEnabled = true;
+
+        if (progress)
+        {
+            SearchProgress snapshot;
+            snapshot.depth = depth;
+            snapshot.bestMove = moveToMake;
+            snapshot.bestValue = m_topLevelNode->getNodeValue();
+            snapshot.elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            progress(snapshot);
+        }
+    }
+
+    m_cancelToken.reset();
+    return moveToMake;
+}
+
+/**
+ * Evaluates the root moves for Algorithm::analyze. All moves are searched with the same tree and transposition
+ * table, so a move profits from everything the moves before it have searched. Once the top moves have exact values,
+ * the remaining moves are only searched until it is clear that they are not better.
+ *
+ * \param depth The maximum search depth.
+ * \param topMoves The number of moves that need an exact value. 0 means all of them.
+ * \param analysis Receives the analysis of all moves, sorted from the best to the worst.
+ */
+void Algorithm::analyzeRoot(int depth, int topMoves, std::vector<MoveAnalysis>& analysis)
+{
+    analysis.clear();
+    if (m_topLevelNode->isGameOver())
+        return;
+
+    if (m_topLevelNode->getChildren().empty())
+    {
+        m_topLevelNode->createNextMoves(1);
+        m_nodeCount += m_topLevelNode->getChildren().size();
+    }
+
+    // The best moves of the previous depth are searched first, so the value that the other moves have to beat is
+    // known early.
+    std::vector<std::shared_ptr<Node>> children = m_topLevelNode->getChildren();
+    std::stable_sort(children.begin(), children.end(),
+        [](const std::shared_ptr<Node>& first, const std::shared_ptr<Node>& second) {
+        return first->getNodeValue() > second->getNodeValue();
+    });
+
+    // Moves that ignore an immediate threat are lost. The others are only extended, never reduced, because their values
+    // are reported.
+    Bitboard board(m_topLevelNode->getKey(), Field::Player::Algorithm);
+    bool threatened = (board.opponentWinningPositions() & board.possibleMoves()) != 0;
+
+    std::vector<int> exactValues;
+    int bestValue = INT_MIN;
+    int bestMove = -1;
+    for (const std::shared_ptr<Node>& child : children)
+    {
+        int alpha = INT_MIN;
+        if (topMoves > 0 && (int)exactValues.size() >= topMoves)
+        {
+            std::sort(exactValues.begin(), exactValues.end(), std::greater<int>());
+            alpha = exactValues[topMoves - 1];
+        }
+
+        int value = isLostMove(child, board, threatened, Field::Player::Algorithm) ? child->getNodeValue()
+            : searchChild(child, board, threatened, 0, depth, alpha, INT_MAX, Field::Player::Algorithm, 0);
+        if (m_stopped)
+            return;
+
+        MoveAnalysis move;
+        move.column = child->getMoveMade();
+        move.value = value;
+        move.bound = alpha != INT_MIN && value <= alpha ? TranspositionTable::Bound::Upper
+            : TranspositionTable::Bound::Exact;
+        if (move.bound == TranspositionTable::Bound::Exact)
+            exactValues.push_back(value);
+
+        move.principalVariation.push_back(move.column);
+        getPrincipalVariation(child, move.principalVariation);
+        analysis.push_back(move);
+
+        if (value > bestValue || bestMove == -1)
+        {
+            bestValue = value;
+            bestMove = move.column;
+        }
+    }
+
+    m_topLevelNode->setNodeValue(bestValue);
+    m_topLevelNode->setBestMove(bestMove);
+
+    std::stable_sort(analysis.begin(), analysis.end(), [](const MoveAnalysis& first, const MoveAnalysis& second) {
+        return first.value > second.value
+            || (first.value == second.value && first.bound == TranspositionTable::Bound::Exact
+                && second.bound != TranspositionTable::Bound::Exact);
+    });
+    if (topMoves > 0 && (int)analysis.size() > topMoves)
+        analysis.resize(topMoves);
+}
+
+/**
+ * Follows the best moves from a node down the tree. The line ends where the tree was not kept, e.g. at the search
+ * depth or below a transposition.
+ *
+ * \param node The node to start at.
+ * \param moves Receives the columns of the moves, the move of the node itself is not added.
+ */
+void Algorithm::getPrincipalVariation(const std::shared_ptr<Node>& node, std::vector<int>& moves)
+{
+    Node* current = node.get();
+    while (current->getBestMove() != -1)
+    {
+        Node* next = nullptr;
+        for (const std::shared_ptr<Node>& child : current->getChildren())
+        {
+            if (child->getMoveMade() == current->getBestMove())
+                next = child.get();
+        }
+
+        if (!next)
+            break;
+
+        moves.push_back(next->getMoveMade());
+        current = next;
+    }
+}
+
+/**
+ * Runs the proof-number search on the root. Narrow forced wins are proven with far fewer nodes than minimax needs,
+ * even if they are deeper than TREE_DEPTH.
+ *
+ * \param field The field of the root.
+ * \param moveToMake Receives the first move of the win, if there is one. Columns start at 1.
+ * \return Returns true if a forced win was proven within the budget.
+ */
+bool Algorithm::findForcedWin(Field field, int& moveToMake)
+{
+    if (m_proofNodeBudget == 0 || field.isGameOver())
+        return false;
+
+    // The proof may only take a share of the time budget, the minimax search still has to complete its first depth.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (m_deadlineEnabled && m_deadline - now < std::chrono::milliseconds(PROOF_MIN_TIME_BUDGET_MS))
+        return false;
 
-    // Evaluate tree
-    minimax(m_topLevelNode, TREE_DEPTH, INT_MIN, INT_MAX, Field::Player::Algorithm);
+    std::chrono::steady_clock::time_point proofDeadline = now + (m_deadline - now) / PROOF_TIME_SHARE;
+    ProofNumberSearch::StopCallback stop = [this, proofDeadline]() {
+        return (m_cancelToken && m_cancelToken->load(std::memory_order_relaxed))
+            || (m_deadlineEnabled && std::chrono::steady_clock::now() >= proofDeadline);
+    };
+
+    TRACE_SCOPE("proofNumberSearch");
+    PERF_SCOPE(PerfCounters::Region::ProofNumberSearch);
+
+    Bitboard board(field, Field::Player::Algorithm);
+    std::vector<int> line;
+    uint64_t startNodes = m_proofNumberSearch->getNodeCount();
+    ProofNumberSearch::Result result = m_proofNumberSearch->proveWin(board, m_proofNodeBudget, line, stop);
+    m_proofNodes = m_proofNumberSearch->getNodeCount() - startNodes;
+    m_searchedNodes += m_proofNodes;
+    if (result != ProofNumberSearch::Result::Win || line.empty())
+        return false;
+
+    // The line contains the moves of both players.
+    moveToMake = line[0] + 1;
+    m_completedDepth = (int)line.size();
+    m_bestValue = INT_MAX;
+    m_topLevelNode->setNodeValue(INT_MAX);
+    m_topLevelNode->setBestMove(moveToMake);
+    return true;
+}
+
+/**
+ * Get the next move by checking which direct child of the top level node has the best outcome.
+ *
+ * \return The number of the column of the best child. -1 if there are no children.
+ */
+int Algorithm::getBestChildMove()
+{
+    // Children that were cut off only have a bound as their value, which can be as high as the value of the best
+    // child. The move minimax picked is the one with the exact value.
+    if (m_topLevelNode->getBestMove() != -1)
+        return m_topLevelNode->getBestMove();
 
-    // Get the next move by checking which direct child has the best outcome
     int bestOutcome = INT_MIN;
     int moveToMake = -1;
-    for (std::shared_ptr<Node> directChild : m_topLevelNode->getChildren())
+    for (const std::shared_ptr<Node>& directChild : m_topLevelNode->getChildren())
     {
-        if (directChild->getNodeValue() > bestOutcome)
+        // Even if every move loses, one of them has to be made.
+        if (directChild->getNodeValue() > bestOutcome || moveToMake == -1)
         {
             bestOutcome = directChild->getNodeValue();
             moveToMake = directChild->getMoveMade();
@@ -54,6 +629,24 @@ int Algorithm::getNextMove(Field field)
     return moveToMake;
 }
 
+/**
+ * Indicates if the running search has to stop, because it was cancelled or its time budget is used up. The first
+ * depth is never stopped, so there always is a move.
+ *
+ * \return Returns true if the search has to stop.
+ */
+bool Algorithm::isStopped()
+{
+    if (m_stopped || !m_stopEnabled)
+        return m_stopped;
+
+    if ((m_cancelToken && m_cancelToken->load(std::memory_order_relaxed))
+        || (m_deadlineEnabled && std::chrono::steady_clock::now() >= m_deadline))
+        m_stopped = true;
+
+    return m_stopped;
+}
+
 /**
  * Minimax function that works recursively.
  *
@@ -62,53 +655,234 @@ int Algorithm::getNextMove(Field field)
  * \param alpha Alpha value for Alpha-Beta pruning.
  * \param beta Beta value for Alpha-Beta pruning.
  * \param nextPlayer The player  that makes the next move in reference to the given node.
+ * \param extensions The plies the line to this node was already extended by, see SelectiveSearch::maxExtensions.
  * \return
  */
-int Algorithm::minimax(std::shared_ptr<Node> node, int depth, int alpha, int beta, Field::Player nextPlayer)
+int Algorithm::minimax(const std::shared_ptr<Node>& node, int depth, int alpha, int beta, Field::Player nextPlayer,
+    int extensions)
 {
+    TRACE_SCOPE_DEPTH("minimax", m_searchDepth - depth);
+    PERF_SCOPE(PerfCounters::Region::Minimax);
+    m_searchedNodes++;
+
+    // The result does not matter anymore, it will be thrown away.
+    if (isStopped())
+        return 0;
+
     // return the evaluation of a node if we have reached the maximum search depth.
     if (depth <= 0 || node->isGameOver())
     {
-        node->evaluateState();
+        node->evaluateState(m_evaluationCache.get(), &m_evaluationStatistics);
         return node->getNodeValue();
     }
 
+    // Check if this position was already evaluated deep enough via another order of moves. The top level node is
+    // always searched, because the values of its children are needed.
+    int alphaOriginal = alpha;
+    int betaOriginal = beta;
+    uint64_t key = node->getKey() | (nextPlayer == Field::Player::Algorithm ? TRANSPOSITION_KEY_ALGORITHM_TO_MOVE : 0);
+    TranspositionTable::Entry entry;
+    bool hasEntry = m_transpositionTable && m_transpositionTable->probe(key, entry);
+    if (hasEntry && node != m_topLevelNode && entry.depth >= depth)
+    {
+        if (entry.bound == TranspositionTable::Bound::Exact)
+            alpha = beta = entry.value;
+        else if (entry.bound == TranspositionTable::Bound::Lower)
+            alpha = std::max(alpha, entry.value);
+        else if (entry.bound == TranspositionTable::Bound::Upper)
+            beta = std::min(beta, entry.value);
+
+        if (beta <= alpha)
+        {
+            node->setNodeValue(entry.value);
+            node->setBestMove(entry.move);
+            return entry.value;
+        }
+    }
+
+    // Create the next level of the tree, if it does not exist yet. Once the tree has reached the memory budget, the
+    // new level only lives until this node is evaluated. The children of the top level node are always kept.
+    bool releaseChildren = false;
+    if (node->getChildren().empty())
+    {
+        node->createNextMoves(1);
+        m_nodeCount += node->getChildren().size();
+        releaseChildren = m_nodeCount > m_maxNodes && node != m_topLevelNode;
+    }
+    const std::vector<std::shared_ptr<Node>>& children = node->getChildren();
+
+    // Search the best move of an earlier search first and the others from the center outwards. Good moves early give
+    // tight bounds for the rest. The top level node keeps the column order, so of several moves with the same value
+    // the search still picks the leftmost one.
+    const std::shared_ptr<Node>* ordered[FIELD_WIDTH];
+    int childCount = (int)children.size();
+    if (node == m_topLevelNode)
+    {
+        for (int childNr = 0; childNr < childCount; childNr++)
+            ordered[childNr] = &children[childNr];
+    }
+    else
+    {
+        orderChildren(children, hasEntry ? entry.move : -1, ordered);
+    }
+
+    // A player that has to block an immediate win has a single move that matters. The others are lost, see
+    // Algorithm::isLostMove.
+    Bitboard board(node->getKey(), nextPlayer);
+    bool threatened = (board.opponentWinningPositions() & board.possibleMoves()) != 0;
+
+    int value;
+    int bestMove = -1;
     if (nextPlayer == Field::Player::Algorithm)
     {
         // Pick the best outcome
-        int max = INT_MIN;
+        value = INT_MIN;
 
-        #pragma omp parallel for
-        for (int index = 0; index < node->getChildren().size(); index++)
+        for (int childNr = 0; childNr < childCount; childNr++)
         {
-            max = std::max(max, minimax(node->getChildren()[index], depth - 1, alpha, beta, Field::Player::Human));
-            alpha = std::max(alpha, max);
+            const std::shared_ptr<Node>& child = *ordered[childNr];
+            int childValue = isLostMove(child, board, threatened, nextPlayer) ? child->getNodeValue()
+                : searchChild(child, board, threatened, childNr, depth, alpha, beta, nextPlayer, extensions);
+            if (childValue > value || bestMove == -1)
+            {
+                value = childValue;
+                bestMove = child->getMoveMade();
+            }
+            alpha = std::max(alpha, value);
 
             // We don't need to check the rest of the children, if the human already has a better choice by taking
             // another branch.
             if (beta <= alpha)
                 break;
         }
-        node->setNodeValue(max);
-        return max;
     }
     else
     {
         // Pick the worst outcome
-        int min = INT_MAX;
+        value = INT_MAX;
 
-        #pragma omp parallel for
-        for (int index = 0; index < node->getChildren().size(); index++)
+        for (int childNr = 0; childNr < childCount; childNr++)
         {
-            min = std::min(min, minimax(node->getChildren()[index], depth - 1, alpha, beta, Field::Player::Algorithm));
-            beta = std::min(beta, min);
+            const std::shared_ptr<Node>& child = *ordered[childNr];
+            int childValue = isLostMove(child, board, threatened, nextPlayer) ? child->getNodeValue()
+                : searchChild(child, board, threatened, childNr, depth, alpha, beta, nextPlayer, extensions);
+            if (childValue < value || bestMove == -1)
+            {
+                value = childValue;
+                bestMove = child->getMoveMade();
+            }
+            beta = std::min(beta, value);
 
             // We don't need to check the rest of the children, if the algorithm already has a better choice by taking
             // another branch.
             if (beta <= alpha)
                 break;
         }
-        node->setNodeValue(min);
-        return min;
     }
+    node->setNodeValue(value);
+    node->setBestMove(bestMove);
+
+    if (releaseChildren)
+    {
+        TRACE_SCOPE("releaseChildren");
+        m_nodeCount -= countDescendants(node);
+        node->releaseChildren();
+    }
+
+    if (m_transpositionTable && !isStopped())
+    {
+        entry.value = value;
+        entry.depth = depth;
+        entry.move = bestMove;
+        if (value <= alphaOriginal)
+            entry.bound = TranspositionTable::Bound::Upper;
+        else if (value >= betaOriginal)
+            entry.bound = TranspositionTable::Bound::Lower;
+        else
+            entry.bound = TranspositionTable::Bound::Exact;
+        m_transpositionTable->store(key, entry);
+    }
+
+    return value;
+}
+
+/**
+ * Checks if a child of a node in Algorithm::minimax loses right away, because it does not block an immediate win of
+ * the opponent. Such a child gets the value of a loss without being searched. This does not depend on the
+ * SelectiveSearch, the value is exact.
+ *
+ * \param child The child.
+ * \param board The field of the node, seen from the player to move.
+ * \param threatened Indicates if the player to move has to block an immediate win of the opponent.
+ * \param nextPlayer The player that makes the move of the child.
+ * \return Returns true if the child loses. Its value is set in that case.
+ */
+bool Algorithm::isLostMove(const std::shared_ptr<Node>& child, const Bitboard& board, bool threatened,
+    Field::Player nextPlayer)
+{
+    int column = child->getMoveMade() - 1;
+    if (!threatened || board.isWinningMove(column))
+        return false;
+
+    uint64_t cell = (board.occupiedMask() + Bitboard::bottomMask(column)) & Bitboard::columnMask(column);
+    if (cell & board.opponentWinningPositions())
+        return false;
+
+    // The child is not searched, so it is not counted in Algorithm::getSearchedNodes.
+    m_selectiveStatistics.lostMoves++;
+    child->setNodeValue(nextPlayer == Field::Player::Algorithm ? INT_MIN : INT_MAX);
+    child->setBestMove(-1);
+    return true;
+}
+
+/**
+ * Searches a child of a node in Algorithm::minimax with the depth the selective depth control gives it, see
+ * SelectiveSearch.
+ *
+ * \param child The child.
+ * \param board The field of the node, seen from the player to move.
+ * \param threatened Indicates if the player to move has to block an immediate win of the opponent.
+ * \param moveIndex The position of the child in the search order of the node.
+ * \param depth The remaining search depth of the node.
+ * \param alpha Alpha value for Alpha-Beta pruning.
+ * \param beta Beta value for Alpha-Beta pruning.
+ * \param nextPlayer The player that makes the move of the child.
+ * \param extensions The plies the line to the node was already extended by.
+ * \return Returns the value of the child.
+ */
+int Algorithm::searchChild(const std::shared_ptr<Node>& child, const Bitboard& board, bool threatened, int moveIndex,
+    int depth, int alpha, int beta, Field::Player nextPlayer, int extensions)
+{
+    Field::Player childPlayer = nextPlayer == Field::Player::Algorithm ? Field::Player::Human
+        : Field::Player::Algorithm;
+    int column = child->getMoveMade() - 1;
+    bool selective = m_selectiveSearch.maxExtensions > 0 || m_selectiveSearch.lateMoveReductions;
+    if (!selective || board.isWinningMove(column))
+        return minimax(child, depth - 1, alpha, beta, childPlayer, extensions);
+
+    // The move threatens to win right away, so the opponent is forced to block.
+    Bitboard childBoard = board;
+    childBoard.play(column);
+    bool threat = (childBoard.opponentWinningPositions() & childBoard.possibleMoves()) != 0;
+    if (threat && extensions < m_selectiveSearch.maxExtensions)
+    {
+        m_selectiveStatistics.extensions++;
+        return minimax(child, depth, alpha, beta, childPlayer, extensions + 1);
+    }
+
+    if (m_selectiveSearch.lateMoveReductions && !threat && !threatened && depth >= m_selectiveSearch.reductionMinDepth
+        && moveIndex >= m_selectiveSearch.reductionMoveIndex)
+    {
+        m_selectiveStatistics.reductions++;
+        int value = minimax(child, depth - 1 - m_selectiveSearch.reduction, alpha, beta, childPlayer, extensions);
+
+        // A move that is not better than alpha (for the algorithm) or beta (for the human) is cut off anyway.
+        bool improves = nextPlayer == Field::Player::Algorithm ? value > alpha : value < beta;
+        if (!improves || m_stopped)
+            return value;
+
+        m_selectiveStatistics.reSearches++;
+    }
+
+    return minimax(child, depth - 1, alpha, beta, childPlayer, extensions);
 }
@@ -1,8 +1,17 @@
 #ifndef ALGORYTHM_H
 #define ALGORYTHM_H
 
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "Engine.h"
+#include "Bitboard.h"
+#include "EvaluationCache.h"
 #include "Field.h"
 #include "Node.h"
+#include "ProofNumberSearch.h"
+#include "SearchHandle.h"
+#include "TranspositionTable.h"
 
 // TREE_DEPTH starts at 0, meaning that the root node will have a depth of 0
 //      O       depth = 0
@@ -11,21 +20,110 @@
 // This would be a tree with the depth of 1.
 constexpr auto TREE_DEPTH = 7;
 
-class Algorithm
+// Estimated memory of a single Node in bytes, including its Field and its share of the parent's child list.
+constexpr size_t NODE_MEMORY_ESTIMATE = 512;
+
+// Nodes the proof-number search may spend on a forced win before the minimax search starts, see
+// Algorithm::setProofNodeBudget.
+constexpr uint64_t DEFAULT_PROOF_NODE_BUDGET = 10000;
+
+// Selective depth control of the minimax search, see Algorithm::setSelectiveSearch. A move that threatens an
+// immediate win is searched one ply deeper, so the forced block does not use up the depth and the threat is judged
+// after it. Quiet moves that are ordered late are searched with less depth first and only searched again with the full
+// depth if they turn out to be better than the moves before them.
+// Both are off by default. At the fixed depth of the Benchmark they visit more nodes and find fewer correct moves
+// than the plain search.
+struct SelectiveSearch
 {
-private:
-    /* Private constructor to prevent instancing. */
-    Algorithm();
+    int     maxExtensions       = 0;        // Plies a single line may be extended by, 0 disables the extensions
+    bool    lateMoveReductions  = false;
+    int     reductionMinDepth   = 3;        // Remaining depth a node needs before its moves are reduced
+    int     reductionMoveIndex  = 3;        // Moves ordered before this one are never reduced, at least 1
+    int     reduction           = 1;        // Plies a late move is reduced by
+};
 
-    int minimax(std::shared_ptr<Node> node, int depth, int alpha, int beta, Field::Player nextPlayer);
+// Work of the selective depth control in the last search, see Algorithm::getSelectiveStatistics.
+struct SelectiveStatistics
+{
+    uint64_t    extensions          = 0;    // Moves searched one ply deeper
+    uint64_t    reductions          = 0;    // Moves searched with reduced depth
+    uint64_t    reSearches          = 0;    // Reduced moves that had to be searched again with the full depth
+    uint64_t    lostMoves           = 0;    // Moves scored as a loss without a search, see Algorithm::isLostMove
+};
 
-    std::shared_ptr<Node> m_topLevelNode;
+// Result of a root move, see Algorithm::analyze. The value is seen from the algorithm like Node::getNodeValue.
+struct MoveAnalysis
+{
+    int                         column      = -1;
+    int                         value       = 0;
+    TranspositionTable::Bound   bound       = TranspositionTable::Bound::Exact;    // Upper: not better than value
+    std::vector<int>            principalVariation;                                 // Starts with column
+};
+
+class Algorithm : public Engine
+{
+private:
+    int search(Field field, int timeBudgetMs, ProgressCallback progress,
+        std::shared_ptr<std::atomic<bool>> cancelToken, std::vector<MoveAnalysis>* analysis = nullptr,
+        int topMoves = 0);
+    void analyzeRoot(int depth, int topMoves, std::vector<MoveAnalysis>& analysis);
+    void getPrincipalVariation(const std::shared_ptr<Node>& node, std::vector<int>& moves);
+    int minimax(const std::shared_ptr<Node>& node, int depth, int alpha, int beta, Field::Player nextPlayer,
+        int extensions);
+    bool isLostMove(const std::shared_ptr<Node>& child, const Bitboard& board, bool threatened,
+        Field::Player nextPlayer);
+    int searchChild(const std::shared_ptr<Node>& child, const Bitboard& board, bool threatened, int moveIndex,
+        int depth, int alpha, int beta, Field::Player nextPlayer, int extensions);
+    int getBestChildMove();
+    bool findForcedWin(Field field, int& moveToMake);
+    bool isStopped();
+    void allocateTables();
+
+    std::shared_ptr<Node>                           m_topLevelNode;
+    std::shared_ptr<TranspositionTable>             m_transpositionTable;
+    std::shared_ptr<EvaluationCache>                m_evaluationCache;
+    bool                                            m_sharedEvaluationCache = false;    // Set by setEvaluationCache
+    std::unique_ptr<ProofNumberSearch>              m_proofNumberSearch;
+    uint64_t                                        m_proofNodeBudget   = DEFAULT_PROOF_NODE_BUDGET;
+    SelectiveSearch                                 m_selectiveSearch;
+    SelectiveStatistics                             m_selectiveStatistics;
+    EvaluationCache::Statistics                     m_evaluationStatistics;
+    std::chrono::steady_clock::time_point           m_deadline;
+    size_t                                          m_memoryBudgetMb    = ENGINE_DEFAULT_MEMORY_BUDGET_MB;
+    size_t                                          m_maxNodes          = 0;
+    size_t                                          m_nodeCount         = 0;
+    int                                             m_searchDepth       = 0;   // Depth of the running iteration
+    uint64_t                                        m_searchedNodes     = 0;
+    uint64_t                                        m_proofNodes        = 0;
+    int                                             m_completedDepth    = 0;
+    int                                             m_bestValue         = 0;
+    std::shared_ptr<std::atomic<bool>>              m_cancelToken;
+    bool                                            m_deadlineEnabled   = false;
+    bool                                            m_stopEnabled       = false;
+    bool                                            m_stopped           = false;
 
 public:
+    Algorithm();
+
     /* Static access method. */
     static Algorithm* getInstance();
 
-    int getNextMove(Field field);
+    std::string name() override;
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> table) override;
+    void setMemoryBudget(size_t megabytes) override;
+    void setProofNodeBudget(uint64_t nodes);
+    void setSelectiveSearch(const SelectiveSearch& selectiveSearch);
+    void setEvaluationCache(std::shared_ptr<EvaluationCache> cache);
+    std::shared_ptr<EvaluationCache> getEvaluationCache();
+    int getNextMove(Field field, int timeBudgetMs = 0) override;
+    SearchHandle getNextMoveAsync(Field field, ProgressCallback progress = nullptr, int timeBudgetMs = 0);
+    std::vector<MoveAnalysis> analyze(Field field, int topMoves = 0, int timeBudgetMs = 0);
+    uint64_t getSearchedNodes();
+    uint64_t getProofNodes();
+    int getCompletedDepth();
+    int getBestValue();
+    SelectiveStatistics getSelectiveStatistics();
+    EvaluationCache::Statistics getEvaluationStatistics();
 };
 
 #endif
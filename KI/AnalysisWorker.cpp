@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Algorithm.h"
+#include "AnalysisWorker.h"
+#include "Socket.h"
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the worker.
+ */
+AnalysisWorker::AnalysisWorker(const Options& options) : m_options(options)
+{
+}
+
+/**
+ * Analyses shards until the coordinator has no more work. A quarter of the memory budget goes to the transposition
+ * table, the rest to the tree.
+ *
+ * \return Returns true if the coordinator told the worker to quit. False means, that the connection failed or broke.
+ */
+bool AnalysisWorker::run()
+{
+    Socket socket;
+    if (!socket.connect(m_options.host, m_options.port))
+        return false;
+
+    Algorithm algorithm;
+    algorithm.setTranspositionTable(std::make_shared<TranspositionTable>(
+        TranspositionTable::entriesForBudget(std::max<size_t>(m_options.memoryBudgetMb / 4, 1))));
+    algorithm.setMemoryBudget(std::max<size_t>(m_options.memoryBudgetMb * 3 / 4, 1));
+
+    if (!socket.writeLine("READY"))
+        return false;
+
+    int shards = 0;
+    std::string line;
+    while (socket.readLine(line))
+    {
+        std::istringstream request(line);
+        std::string command;
+        uint64_t id;
+        int timeBudgetMs;
+        request >> command;
+        if (command == "QUIT")
+            return true;
+        else if (command != "SHARD" || !(request >> id >> timeBudgetMs))
+            return false;
+
+        if (shards++ == m_options.exitAfterShards)
+            return false;
+
+        // The algorithm is always the player to move, so the first player depends on the number of moves.
+        std::ostringstream response;
+        response << "RESULT " << id;
+        std::string moves;
+        while (request >> moves)
+        {
+            if (moves == "-")
+                moves.clear();
+
+            Field field;
+            Field::Player firstPlayer = moves.size() % 2 == 0 ? Field::Player::Algorithm : Field::Player::Human;
+            if (!field.placeStones(moves, firstPlayer) || field.isGameOver())
+            {
+                response << " 0 0 0";
+                continue;
+            }
+
+            std::vector<MoveAnalysis> analysis = algorithm.analyze(field, 1, timeBudgetMs);
+            response << ' ' << analysis[0].column << ' ' << analysis[0].value << ' ' << algorithm.getCompletedDepth();
+        }
+
+        if (!socket.writeLine(response.str()))
+            return false;
+    }
+
+    return false;
+}
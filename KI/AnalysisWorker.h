@@ -0,0 +1,29 @@
+#ifndef ANALYSISWORKER_H
+#define ANALYSISWORKER_H
+
+#include <cstdint>
+#include <string>
+#include "Engine.h"
+
+// Worker of the Coordinator. It connects to the coordinator, analyses the shards it gets with its own Algorithm and
+// sends the results back until it is told to quit. See Coordinator for the protocol.
+class AnalysisWorker
+{
+public:
+    struct Options
+    {
+        std::string     host            = "127.0.0.1";
+        uint16_t        port            = 4445;
+        size_t          memoryBudgetMb  = ENGINE_DEFAULT_MEMORY_BUDGET_MB;
+        int             exitAfterShards = -1;   // Quits without an answer when this shard arrives, to test re-queueing
+    };
+
+    AnalysisWorker(const Options& options);
+
+    bool run();
+
+private:
+    Options     m_options;
+};
+
+#endif
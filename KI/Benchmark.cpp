@@ -0,0 +1,399 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+
+#include "Algorithm.h"
+#include "Benchmark.h"
+#include "Bitboard.h"
+#include "Solver.h"
+
+/**
+ * Helper function to calculate how many moves it takes until the game is decided with perfect play.
+ *
+ * \param score The exact score of the position, see SOLVER_MIN_SCORE.
+ * \param stones The number of stones on the field.
+ * \return Returns the number of moves including the winning move, or the moves until the field is full for a draw.
+ */
+static int distanceToEnd(int score, int stones)
+{
+    if (score == 0)
+        return FIELD_WIDTH * FIELD_HEIGHT - stones;
+
+    // A score stands for the number of stones the winner has left, so it gives the stones on the field before the
+    // winning move. Only every second move belongs to the winner.
+    int winnerStones = score > 0 ? stones : stones + 1;
+    int stonesBeforeWin = FIELD_WIDTH * FIELD_HEIGHT + 1 - 2 * std::abs(score);
+    if ((stonesBeforeWin - winnerStones) % 2 != 0)
+        stonesBeforeWin--;
+
+    return stonesBeforeWin - stones + 1;
+}
+
+/**
+ * Helper function to compare the result of a position with a score. Only the kind of the result counts.
+ *
+ * \param first The first score.
+ * \param second The second score.
+ * \return Returns true if both scores are wins, draws or losses.
+ */
+static bool isSameResult(int first, int second)
+{
+    return (first > 0) == (second > 0) && (first < 0) == (second < 0);
+}
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the benchmark.
+ */
+Benchmark::Benchmark(const Options& options) : m_options(options)
+{
+}
+
+/**
+ * Runs the Algorithm on all positions of all sets.
+ *
+ * \param results Receives one result per set.
+ * \return Returns true if the operation was successful. False means, that a set could not be read.
+ */
+bool Benchmark::run(std::vector<SetResult>& results)
+{
+    results.clear();
+
+    // Every position is searched with an empty transposition table and evaluation cache, so the results do not depend
+    // on the order.
+    std::shared_ptr<TranspositionTable> transpositionTable = std::make_shared<TranspositionTable>();
+    Algorithm algorithm;
+    algorithm.setTranspositionTable(transpositionTable);
+    algorithm.setSelectiveSearch(m_options.selectiveSearch);
+
+    for (const SetDefinition& definition : sets())
+    {
+        std::vector<Position> positions;
+        if (!readSet(definition.name, positions))
+            return false;
+
+        SetResult result;
+        result.name = definition.name;
+        EvaluationCache::Statistics evaluationStatistics;
+        for (const Position& position : positions)
+        {
+            // The algorithm is always the player to move.
+            Field field;
+            Field::Player firstPlayer = position.moves.size() % 2 == 0 ? Field::Player::Algorithm
+                : Field::Player::Human;
+            if (!field.placeStones(position.moves, firstPlayer))
+                return false;
+
+            transpositionTable->clear();
+            algorithm.getEvaluationCache()->clear();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            int move = algorithm.getNextMove(field, m_options.timeBudgetMs);
+            result.meanMs += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            result.meanNodes += (double)algorithm.getSearchedNodes();
+            evaluationStatistics += algorithm.getEvaluationStatistics();
+
+            int moveScore = move >= 1 && move <= FIELD_WIDTH ? position.moveScores[move - 1] : SOLVER_INVALID_SCORE;
+            if (moveScore != SOLVER_INVALID_SCORE && isSameResult(moveScore, position.score))
+                result.correct++;
+            if (moveScore == position.score)
+                result.optimal++;
+            result.positions++;
+        }
+
+        if (result.positions > 0)
+        {
+            result.meanMs /= result.positions;
+            result.meanNodes /= result.positions;
+        }
+        result.evaluationHits = evaluationStatistics.getHitRate();
+        results.push_back(result);
+    }
+
+    return true;
+}
+
+/**
+ * Compares results with the baseline. A set regresses if less moves are correct, or if more nodes or more time are
+ * needed than the tolerance allows. Sets that are missing in the baseline are not compared.
+ *
+ * \param results The results of Benchmark::run.
+ * \param regressions Receives a description of every regression.
+ * \return Returns true if the operation was successful. False means, that the baseline could not be read.
+ */
+bool Benchmark::compare(const std::vector<SetResult>& results, std::vector<std::string>& regressions)
+{
+    regressions.clear();
+    std::vector<SetResult> baseline;
+    if (!readBaseline(baseline))
+        return false;
+
+    for (const SetResult& result : results)
+    {
+        for (const SetResult& expected : baseline)
+        {
+            if (expected.name != result.name)
+                continue;
+
+            std::ostringstream regression;
+            if (result.correct < expected.correct)
+                regression << result.correct << " correct moves instead of " << expected.correct;
+            else if (result.meanNodes > expected.meanNodes * (1 + m_options.nodeTolerancePercent / 100.0))
+                regression << result.meanNodes << " mean nodes instead of " << expected.meanNodes;
+            else if (m_options.timeTolerancePercent >= 0
+                && result.meanMs > expected.meanMs * (1 + m_options.timeTolerancePercent / 100.0))
+                regression << result.meanMs << " mean ms instead of " << expected.meanMs;
+
+            if (!regression.str().empty())
+                regressions.push_back(result.name + ": " + regression.str());
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Replaces the baseline with new results.
+ *
+ * \param results The results of Benchmark::run.
+ * \return Returns true if the operation was successful.
+ */
+bool Benchmark::writeBaseline(const std::vector<SetResult>& results)
+{
+    std::ofstream stream(m_options.baseline, std::ios::trunc);
+    if (!stream)
+        return false;
+
+    stream << "# Benchmark baseline, written by \"connect_4 benchmark --write 1\"." << std::endl
+        << "# set positions correct optimal meanNodes meanMs" << std::endl;
+    for (const SetResult& result : results)
+    {
+        stream << result.name << ' ' << result.positions << ' ' << result.correct << ' ' << result.optimal << ' '
+            << std::fixed << std::setprecision(1) << result.meanNodes << ' ' << std::setprecision(3) << result.meanMs
+            << std::endl;
+    }
+
+    return stream.good();
+}
+
+/**
+ * Creates all sets from random games and solves their positions. Existing sets are replaced.
+ *
+ * \param positionsPerSet The number of positions of every set.
+ * \param seed The seed of the random games.
+ * \return Returns true if the operation was successful. False means, that a set could not be written.
+ */
+bool Benchmark::generate(int positionsPerSet, uint32_t seed)
+{
+    Solver solver;
+    std::mt19937 random(seed);
+    std::vector<std::vector<Position>> positions(sets().size());
+    std::set<uint64_t> knownKeys;
+
+    size_t fullSets = 0;
+    while (fullSets < sets().size())
+    {
+        // Play random moves until a stone count is reached that still has open sets.
+        int stones = 10 + (int)(random() % (FIELD_WIDTH * FIELD_HEIGHT - 10));
+        bool wanted = false;
+        for (size_t setNr = 0; setNr < sets().size(); setNr++)
+        {
+            wanted |= stones >= sets()[setNr].minStones && stones <= sets()[setNr].maxStones
+                && (int)positions[setNr].size() < positionsPerSet;
+        }
+        if (!wanted)
+            continue;
+
+        Bitboard board;
+        std::string moves;
+        bool gameOver = false;
+        while (board.moveCount() < stones && !gameOver)
+        {
+            int column;
+            do
+            {
+                column = (int)(random() % FIELD_WIDTH);
+            } while (!board.canPlay(column));
+
+            gameOver = board.isWinningMove(column);
+            board.play(column);
+            moves += (char)('1' + column);
+        }
+
+        // Positions with a win in one move say nothing about the search.
+        if (gameOver || (board.winningPositions() & board.possibleMoves()) || !knownKeys.insert(board.key()).second)
+            continue;
+
+        int score = solver.solve(board);
+        int distance = distanceToEnd(score, stones);
+        for (size_t setNr = 0; setNr < sets().size(); setNr++)
+        {
+            const SetDefinition& definition = sets()[setNr];
+            if (stones < definition.minStones || stones > definition.maxStones || distance < definition.minDistance
+                || distance > definition.maxDistance || (int)positions[setNr].size() >= positionsPerSet)
+                continue;
+
+            Position position;
+            position.moves = moves;
+            position.score = score;
+            solver.analyze(board, position.moveScores);
+            positions[setNr].push_back(position);
+
+            if ((int)positions[setNr].size() == positionsPerSet)
+                fullSets++;
+        }
+    }
+
+    for (size_t setNr = 0; setNr < sets().size(); setNr++)
+    {
+        std::ofstream stream(setPath(sets()[setNr].name), std::ios::trunc);
+        if (!stream)
+            return false;
+
+        stream << "# " << sets()[setNr].name << ", written by \"connect_4 benchmark-sets --seed " << seed << "\"."
+            << std::endl << "# moves score score-of-column-1 ... score-of-column-7" << std::endl;
+        for (const Position& position : positions[setNr])
+        {
+            stream << position.moves << ' ' << position.score;
+            for (int column = 0; column < FIELD_WIDTH; column++)
+            {
+                if (position.moveScores[column] == SOLVER_INVALID_SCORE)
+                    stream << " x";
+                else
+                    stream << ' ' << position.moveScores[column];
+            }
+            stream << std::endl;
+        }
+
+        if (!stream.good())
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Prints results to the console.
+ *
+ * \param results The results of Benchmark::run.
+ */
+void Benchmark::printReport(const std::vector<SetResult>& results)
+{
+    std::cout << std::left << std::setw(16) << "set" << std::right << std::setw(10) << "positions"
+        << std::setw(10) << "correct" << std::setw(10) << "optimal" << std::setw(14) << "mean nodes"
+        << std::setw(12) << "mean ms" << std::setw(12) << "eval hits" << std::endl;
+    for (const SetResult& result : results)
+    {
+        std::cout << std::left << std::setw(16) << result.name << std::right << std::setw(10) << result.positions
+            << std::setw(10) << result.correct << std::setw(10) << result.optimal << std::fixed
+            << std::setprecision(1) << std::setw(14) << result.meanNodes << std::setprecision(3) << std::setw(12)
+            << result.meanMs << std::setprecision(1) << std::setw(11) << result.evaluationHits * 100 << '%'
+            << std::endl;
+    }
+}
+
+/**
+ * Gives info about the sets of the benchmark. These are the stages and difficulties of the test sets that are
+ * commonly used for Connect 4 solvers.
+ *
+ * \return Returns all sets.
+ */
+const std::vector<Benchmark::SetDefinition>& Benchmark::sets()
+{
+    static const std::vector<SetDefinition> definitions = {
+        { "end-easy",       28, 41, 1, 6 },
+        { "middle-easy",    14, 27, 1, 6 },
+        { "middle-medium",  14, 27, 7, 14 },
+        { "begin-easy",     10, 13, 1, 6 },
+        { "begin-medium",   10, 13, 7, 14 },
+        { "begin-hard",     10, 13, 15, FIELD_WIDTH * FIELD_HEIGHT }
+    };
+
+    return definitions;
+}
+
+/**
+ * Reads the positions of a set.
+ *
+ * \param name The name of the set.
+ * \param positions Receives the positions.
+ * \return Returns true if the operation was successful. False means, that the file is missing or not valid.
+ */
+bool Benchmark::readSet(const std::string& name, std::vector<Position>& positions)
+{
+    std::ifstream stream(setPath(name));
+    if (!stream)
+        return false;
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream lineStream(line);
+        Position position;
+        if (!(lineStream >> position.moves >> position.score))
+            return false;
+
+        for (int column = 0; column < FIELD_WIDTH; column++)
+        {
+            std::string moveScore;
+            if (!(lineStream >> moveScore))
+                return false;
+
+            position.moveScores[column] = moveScore == "x" ? SOLVER_INVALID_SCORE : std::atoi(moveScore.c_str());
+        }
+        positions.push_back(position);
+    }
+
+    return true;
+}
+
+/**
+ * Reads the results of the baseline.
+ *
+ * \param baseline Receives one result per set.
+ * \return Returns true if the operation was successful. False means, that the file is missing or not valid.
+ */
+bool Benchmark::readBaseline(std::vector<SetResult>& baseline)
+{
+    std::ifstream stream(m_options.baseline);
+    if (!stream)
+        return false;
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream lineStream(line);
+        SetResult result;
+        if (!(lineStream >> result.name >> result.positions >> result.correct >> result.optimal >> result.meanNodes
+            >> result.meanMs))
+            return false;
+
+        baseline.push_back(result);
+    }
+
+    return true;
+}
+
+/**
+ * Gives info about the file of a set.
+ *
+ * \param name The name of the set.
+ * \return Returns the path of the file.
+ */
+std::string Benchmark::setPath(const std::string& name)
+{
+    return m_options.directory + "/" + name + ".txt";
+}
@@ -0,0 +1,75 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Algorithm.h"
+#include "Field.h"
+
+// Runs the Algorithm on sets of positions with known exact scores and compares the results with a baseline. The sets
+// are split by the stage of the game (stones on the field) and by their difficulty (moves until the game is decided
+// with perfect play):
+//  begin:  10 - 13 stones      easy:   up to 6 moves
+//  middle: 14 - 27 stones      medium: 7 - 14 moves
+//  end:    28 - 41 stones      hard:   15 moves or more
+// Every line of a set is "<moves> <score> <score of column 1> ... <score of column 7>". The moves are the columns
+// played from the empty field, e.g. "4453". Scores are those of Solver, a full column has the score "x".
+class Benchmark
+{
+public:
+    struct Options
+    {
+        std::string     directory               = "Benchmarks";
+        std::string     baseline                = "Benchmarks/baseline.txt";
+        int             nodeTolerancePercent    = 5;
+        int             timeTolerancePercent    = 50;   // Negative values disable the time check
+        int             timeBudgetMs            = 0;
+        SelectiveSearch selectiveSearch;
+    };
+
+    struct SetResult
+    {
+        std::string     name;
+        int             positions       = 0;
+        int             correct         = 0;    // The move keeps the best possible result (win, draw or loss)
+        int             optimal         = 0;    // The move has the best possible score
+        double          meanNodes       = 0;
+        double          meanMs          = 0;
+        double          evaluationHits  = 0;    // Share of leaf evaluations taken from the EvaluationCache
+    };
+
+    Benchmark(const Options& options);
+
+    bool run(std::vector<SetResult>& results);
+    bool compare(const std::vector<SetResult>& results, std::vector<std::string>& regressions);
+    bool writeBaseline(const std::vector<SetResult>& results);
+    bool generate(int positionsPerSet, uint32_t seed);
+    void printReport(const std::vector<SetResult>& results);
+
+private:
+    struct Position
+    {
+        std::string     moves;
+        int             score;
+        int             moveScores[FIELD_WIDTH];
+    };
+
+    struct SetDefinition
+    {
+        const char*     name;
+        int             minStones;
+        int             maxStones;
+        int             minDistance;
+        int             maxDistance;
+    };
+
+    static const std::vector<SetDefinition>& sets();
+    bool readSet(const std::string& name, std::vector<Position>& positions);
+    bool readBaseline(std::vector<SetResult>& baseline);
+    std::string setPath(const std::string& name);
+
+    Options     m_options;
+};
+
+#endif
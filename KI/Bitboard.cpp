@@ -0,0 +1,258 @@
+#include "Bitboard.h"
+
+constexpr uint64_t BOARD_MASK = KEY_BOTTOM_MASK * ((uint64_t(1) << FIELD_HEIGHT) - 1);
+
+/**
+ * Public constructor. Creates an empty field.
+ *
+ */
+Bitboard::Bitboard()
+{
+}
+
+/**
+ * Public constructor. Converts a field.
+ *
+ * \param field The field to convert.
+ * \param nextPlayer The player that makes the next move.
+ */
+Bitboard::Bitboard(Field field, Field::Player nextPlayer) : Bitboard(field.getKey(), nextPlayer)
+{
+}
+
+/**
+ * Public constructor. Converts the packed key of a field without creating the field.
+ *
+ * \param key The packed key as returned by Field::getKey.
+ * \param nextPlayer The player that makes the next move.
+ */
+Bitboard::Bitboard(uint64_t key, Field::Player nextPlayer)
+{
+    // The key contains a marker bit above every column, see KEY_COLUMN_BITS.
+    uint64_t markers = 0;
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        uint64_t marker = key & (KEY_COLUMN_MASK << (column * KEY_COLUMN_BITS));
+        while (marker & (marker - 1))
+            marker &= marker - 1;
+
+        markers |= marker;
+    }
+
+    uint64_t algorithmStones = key - markers;
+    m_mask = markers - KEY_BOTTOM_MASK;
+    m_current = nextPlayer == Field::Player::Algorithm ? algorithmStones : m_mask ^ algorithmStones;
+    m_moves = popCount(m_mask);
+}
+
+/**
+ * Indicates if a stone can be placed in a column.
+ *
+ * \param column The column starting at 0.
+ * \return Returns true if the column is not full.
+ */
+bool Bitboard::canPlay(int column) const
+{
+    return (m_mask & topMask(column)) == 0;
+}
+
+/**
+ * Places a stone of the player to move. The column must be playable.
+ *
+ * \param column The column starting at 0.
+ */
+void Bitboard::play(int column)
+{
+    m_current ^= m_mask;
+    m_mask |= m_mask + bottomMask(column);
+    m_moves++;
+}
+
+/**
+ * Indicates if placing a stone in a column wins the game for the player to move. The column must be playable.
+ *
+ * \param column The column starting at 0.
+ * \return Returns true if the move wins.
+ */
+bool Bitboard::isWinningMove(int column) const
+{
+    return winningPositions() & possibleMoves() & columnMask(column);
+}
+
+/**
+ * Indicates if all columns are full.
+ *
+ * \return Returns true if no move is possible.
+ */
+bool Bitboard::isFull() const
+{
+    return m_moves >= FIELD_WIDTH * FIELD_HEIGHT;
+}
+
+/**
+ * Gives info about the number of stones on the field.
+ *
+ * \return Returns the number of moves played.
+ */
+int Bitboard::moveCount() const
+{
+    return m_moves;
+}
+
+/**
+ * Packs the field into a key relative to the player to move. Two fields with the same key are the same for the
+ * player to move, even if the colors are swapped.
+ *
+ * \return Returns the key.
+ */
+uint64_t Bitboard::key() const
+{
+    return m_current + m_mask + KEY_BOTTOM_MASK;
+}
+
+/**
+ * Gives info about all cells a stone can be placed in with the next move.
+ *
+ * \return Returns one bit per playable column.
+ */
+uint64_t Bitboard::possibleMoves() const
+{
+    return (m_mask + KEY_BOTTOM_MASK) & BOARD_MASK;
+}
+
+/**
+ * Gives info about the moves that do not lose right away. A move loses if the opponent could still win with its next
+ * move somewhere else, or if it makes a cell playable on which the opponent wins.
+ *
+ * \return Returns one bit per playable column that does not lose. 0 if every move loses.
+ */
+uint64_t Bitboard::possibleNonLosingMoves() const
+{
+    uint64_t possible = possibleMoves();
+    uint64_t opponentWins = opponentWinningPositions();
+    uint64_t forcedMoves = possible & opponentWins;
+    if (forcedMoves)
+    {
+        // Two threats at the same time can not both be blocked.
+        if (forcedMoves & (forcedMoves - 1))
+            return 0;
+
+        possible = forcedMoves;
+    }
+
+    return possible & ~(opponentWins >> 1);
+}
+
+/**
+ * Gives info about all free cells that complete a line of the player to move.
+ *
+ * \return Returns the cells as a bitmask.
+ */
+uint64_t Bitboard::winningPositions() const
+{
+    return computeWinningPositions(m_current, m_mask);
+}
+
+/**
+ * Gives info about all free cells that complete a line of the opponent.
+ *
+ * \return Returns the cells as a bitmask.
+ */
+uint64_t Bitboard::opponentWinningPositions() const
+{
+    return computeWinningPositions(m_current ^ m_mask, m_mask);
+}
+
+/**
+ * Getter for the stones of the player to move.
+ *
+ * \return Returns the stones as a bitmask.
+ */
+uint64_t Bitboard::currentStones() const
+{
+    return m_current;
+}
+
+/**
+ * Getter for all stones on the field.
+ *
+ * \return Returns the stones as a bitmask.
+ */
+uint64_t Bitboard::occupiedMask() const
+{
+    return m_mask;
+}
+
+/**
+ * Gives info about the cells of a column.
+ *
+ * \param column The column starting at 0.
+ * \return Returns all playable cells of the column as a bitmask.
+ */
+uint64_t Bitboard::columnMask(int column)
+{
+    return ((uint64_t(1) << FIELD_HEIGHT) - 1) << (column * KEY_COLUMN_BITS);
+}
+
+/**
+ * Gives info about the topmost cell of a column.
+ *
+ * \param column The column starting at 0.
+ * \return Returns the cell as a bitmask.
+ */
+uint64_t Bitboard::topMask(int column)
+{
+    return uint64_t(1) << (FIELD_HEIGHT - 1 + column * KEY_COLUMN_BITS);
+}
+
+/**
+ * Gives info about the bottom cell of a column.
+ *
+ * \param column The column starting at 0.
+ * \return Returns the cell as a bitmask.
+ */
+uint64_t Bitboard::bottomMask(int column)
+{
+    return uint64_t(1) << (column * KEY_COLUMN_BITS);
+}
+
+/**
+ * Counts the set bits of a value.
+ *
+ * \param value The value to count.
+ * \return Returns the number of set bits.
+ */
+int Bitboard::popCount(uint64_t value)
+{
+    int count = 0;
+    for (; value; count++)
+        value &= value - 1;
+
+    return count;
+}
+
+/**
+ * Helper method to find the free cells that complete a line.
+ *
+ * \param stones The stones of the player.
+ * \param mask All stones on the field.
+ * \return Returns the cells as a bitmask.
+ */
+uint64_t Bitboard::computeWinningPositions(uint64_t stones, uint64_t mask)
+{
+    // Vertical
+    uint64_t result = (stones << 1) & (stones << 2) & (stones << 3);
+
+    // Horizontal and both diagonals. The shift is the distance between two neighbouring cells of the line.
+    for (int shift : { KEY_COLUMN_BITS, KEY_COLUMN_BITS - 1, KEY_COLUMN_BITS + 1 })
+    {
+        uint64_t pairs = (stones << shift) & (stones << 2 * shift);
+        result |= pairs & (stones << 3 * shift);
+        result |= pairs & (stones >> shift);
+        pairs = (stones >> shift) & (stones >> 2 * shift);
+        result |= pairs & (stones << shift);
+        result |= pairs & (stones >> 3 * shift);
+    }
+
+    return result & (BOARD_MASK ^ mask);
+}
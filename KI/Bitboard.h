@@ -0,0 +1,43 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "Field.h"
+
+// Compact field for the search code that has to play millions of moves, e.g. random playouts or exact solving. It uses
+// the same bit layout as the packed key of Field (see KEY_COLUMN_BITS), but stores the stones relative to the player
+// to move. Unlike Field all columns are zero based.
+class Bitboard
+{
+public:
+    Bitboard();
+    Bitboard(Field field, Field::Player nextPlayer);
+    Bitboard(uint64_t key, Field::Player nextPlayer);
+
+    bool canPlay(int column) const;
+    void play(int column);
+    bool isWinningMove(int column) const;
+    bool isFull() const;
+    int moveCount() const;
+    uint64_t key() const;
+    uint64_t possibleMoves() const;
+    uint64_t possibleNonLosingMoves() const;
+    uint64_t winningPositions() const;
+    uint64_t opponentWinningPositions() const;
+    uint64_t currentStones() const;
+    uint64_t occupiedMask() const;
+
+    static uint64_t columnMask(int column);
+    static uint64_t topMask(int column);
+    static uint64_t bottomMask(int column);
+    static int popCount(uint64_t value);
+
+private:
+    static uint64_t computeWinningPositions(uint64_t stones, uint64_t mask);
+
+    uint64_t    m_current   = 0;    // Stones of the player to move
+    uint64_t    m_mask      = 0;    // All stones
+    int         m_moves     = 0;
+};
+
+#endif
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+#include "Coordinator.h"
+
+/**
+ * Helper function to set up the field of a position. The algorithm is the player to move.
+ *
+ * \param moves The moves of the position, see Coordinator.
+ * \param field Receives the position.
+ * \return Returns true if the moves are valid and the game is not over.
+ */
+static bool createField(const std::string& moves, Field& field)
+{
+    std::string columns = moves == "-" ? std::string() : moves;
+    Field::Player firstPlayer = columns.size() % 2 == 0 ? Field::Player::Algorithm : Field::Player::Human;
+    field = Field();
+    return field.placeStones(columns, firstPlayer) && !field.isGameOver();
+}
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the coordinator.
+ */
+Coordinator::Coordinator(const Options& options) : m_options(options)
+{
+}
+
+/**
+ * Destructor. Ends local workers that are still running.
+ *
+ */
+Coordinator::~Coordinator()
+{
+    for (const std::unique_ptr<Process>& process : m_processes)
+    {
+        if (process->isRunning())
+            process->kill();
+    }
+}
+
+/**
+ * Analyses positions with the workers. Starts the local workers, if there are any, and waits until every shard was
+ * analysed or has failed too often.
+ *
+ * \param positions The positions to analyse, see Coordinator.
+ * \param results Receives one record per position in the same order. Positions that could not be analysed get a
+ * record without flags.
+ * \param report Receives statistics about the run.
+ * \return Returns true if the operation was successful. False means, that the port could not be opened or no local
+ * worker could be started.
+ */
+bool Coordinator::run(const std::vector<std::string>& positions, std::vector<PositionRecord>& results, Report& report)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    m_positions = &positions;
+    m_results = &results;
+    results.assign(positions.size(), PositionRecord());
+    m_report = Report();
+    m_report.positions = positions.size();
+
+    m_shards.clear();
+    m_pendingShards.clear();
+    for (size_t first = 0; first < positions.size(); first += std::max<size_t>(m_options.shardSize, 1))
+    {
+        Shard shard;
+        shard.first = first;
+        shard.count = std::min(std::max<size_t>(m_options.shardSize, 1), positions.size() - first);
+        m_pendingShards.push_back(m_shards.size());
+        m_shards.push_back(shard);
+    }
+    m_openShards = m_shards.size();
+    m_report.shards = m_shards.size();
+    m_stopping = false;
+
+    if (!m_listener.listen(m_options.host, m_options.port))
+        return false;
+
+    m_acceptThread = std::thread(&Coordinator::acceptWorkers, this);
+
+    int workerCount = m_options.workers > 0 ? m_options.workers
+        : (int)std::max(std::thread::hardware_concurrency(), 1u);
+    m_processes.clear();
+    if (!m_options.executable.empty())
+    {
+        for (int workerNr = 0; workerNr < workerCount; workerNr++)
+            m_processes.emplace_back(new Process());
+    }
+
+    bool started = m_processes.empty();
+    for (const std::unique_ptr<Process>& process : m_processes)
+        started |= startWorker(*process);
+
+    if (started)
+        superviseWorkers();
+
+    // Idle workers are told to quit by their threads, busy ones finish their shard first.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    m_listener.shutdown();
+    m_acceptThread.join();
+
+    std::vector<std::thread> workerThreads;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        workerThreads.swap(m_workerThreads);
+    }
+    for (std::thread& thread : workerThreads)
+        thread.join();
+
+    m_listener.close();
+    for (const std::unique_ptr<Process>& process : m_processes)
+        process->wait();
+
+    m_report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report = m_report;
+    return started;
+}
+
+/**
+ * Gives info about the port the coordinator listens on while it runs.
+ *
+ * \return Returns the port. This is useful if the coordinator was started with port 0.
+ */
+uint16_t Coordinator::port()
+{
+    return m_listener.localPort();
+}
+
+/**
+ * Reads positions from a file with one position per line. Empty lines and lines starting with '#' are skipped.
+ *
+ * \param path The path of the file.
+ * \param positions Receives the positions.
+ * \return Returns true if the operation was successful. False means, that the file is missing or a position is not
+ * valid.
+ */
+bool Coordinator::readPositions(const std::string& path, std::vector<std::string>& positions)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        return false;
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        Field field;
+        if (!createField(line, field))
+            return false;
+
+        positions.push_back(line);
+    }
+
+    return true;
+}
+
+/**
+ * Creates all positions after a number of moves, e.g. as the frontier of an opening book. Positions that can be
+ * reached by several orders of moves are only added once, positions where the game is over are left out.
+ *
+ * \param depth The number of moves from the empty field.
+ * \param positions Receives the positions.
+ */
+void Coordinator::expandFrontier(int depth, std::vector<std::string>& positions)
+{
+    std::vector<std::string> frontier = { "" };
+    for (int moveNr = 0; moveNr < depth; moveNr++)
+    {
+        std::vector<std::string> next;
+        std::set<uint64_t> knownKeys;
+        for (const std::string& moves : frontier)
+        {
+            for (int column = 1; column <= FIELD_WIDTH; column++)
+            {
+                Field field;
+                std::string nextMoves = moves + (char)('0' + column);
+                if (createField(nextMoves, field) && knownKeys.insert(field.getKey()).second)
+                    next.push_back(nextMoves);
+            }
+        }
+        frontier.swap(next);
+    }
+
+    for (const std::string& moves : frontier)
+        positions.push_back(moves.empty() ? "-" : moves);
+}
+
+/**
+ * Prints a report to the console.
+ *
+ * \param report The report to print.
+ */
+void Coordinator::printReport(const Report& report)
+{
+    std::cout << "positions:          " << report.positions << std::endl
+        << "shards:             " << report.shards << std::endl
+        << "requeued shards:    " << report.requeuedShards << std::endl
+        << "failed shards:      " << report.failedShards << std::endl
+        << "restarted workers:  " << report.restartedWorkers << std::endl
+        << "seconds:            " << report.seconds << std::endl;
+}
+
+/**
+ * Accepts workers until the coordinator stops. Every worker gets its own thread.
+ *
+ */
+void Coordinator::acceptWorkers()
+{
+    while (true)
+    {
+        std::shared_ptr<Socket> connection = std::make_shared<Socket>();
+        if (!m_listener.accept(*connection))
+            break;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping)
+            break;
+
+        m_workerThreads.emplace_back(&Coordinator::serveWorker, this, connection);
+    }
+}
+
+/**
+ * Hands out shards to a single worker until there is no more work or the worker disconnects. The shard of a worker
+ * that disconnects is queued again.
+ *
+ * \param connection The connection to the worker.
+ */
+void Coordinator::serveWorker(std::shared_ptr<Socket> connection)
+{
+    size_t shardNr = 0;
+    bool assigned = false;
+    std::string line;
+    while (connection->readLine(line))
+    {
+        std::istringstream response(line);
+        std::string command;
+        response >> command;
+        if (command == "RESULT")
+        {
+            uint64_t id;
+            if (!assigned || !(response >> id) || id != shardNr || !storeResult(shardNr, response))
+                break;
+
+            assigned = false;
+        }
+        else if (command != "READY")
+        {
+            break;
+        }
+
+        if (!takeShard(shardNr))
+        {
+            connection->writeLine("QUIT");
+            break;
+        }
+        assigned = true;
+
+        std::ostringstream request;
+        request << "SHARD " << shardNr << ' ' << m_options.timeBudgetMs;
+        for (size_t index = 0; index < m_shards[shardNr].count; index++)
+            request << ' ' << (*m_positions)[m_shards[shardNr].first + index];
+
+        if (!connection->writeLine(request.str()))
+            break;
+    }
+
+    if (assigned)
+        returnShard(shardNr);
+    connection->close();
+}
+
+/**
+ * Takes the next shard from the queue. Waits while the queue is empty, but other workers still have shards that could
+ * be queued again.
+ *
+ * \param shardNr Receives the index of the shard.
+ * \return Returns true if there is a shard. False means, that all work is done.
+ */
+bool Coordinator::takeShard(size_t& shardNr)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_stopping || !m_pendingShards.empty() || m_openShards == 0; });
+    if (m_stopping || m_pendingShards.empty())
+        return false;
+
+    shardNr = m_pendingShards.front();
+    m_pendingShards.pop_front();
+    m_shards[shardNr].attempts++;
+    return true;
+}
+
+/**
+ * Queues a shard again, because its worker disconnected. A shard that has failed too often is given up.
+ *
+ * \param shardNr The index of the shard.
+ */
+void Coordinator::returnShard(size_t shardNr)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Shard& shard = m_shards[shardNr];
+        if (shard.done)
+            return;
+
+        if (shard.attempts >= m_options.maxAttempts)
+        {
+            shard.done = true;
+            m_openShards--;
+            m_report.failedShards++;
+        }
+        else
+        {
+            m_pendingShards.push_back(shardNr);
+            m_report.requeuedShards++;
+        }
+    }
+    m_condition.notify_all();
+}
+
+/**
+ * Stores the results of a shard. Results of a shard that is already done, e.g. because it was queued again after a
+ * timeout of its first worker, are ignored.
+ *
+ * \param shardNr The index of the shard.
+ * \param response The rest of the RESULT line.
+ * \return Returns true if the results are valid.
+ */
+bool Coordinator::storeResult(size_t shardNr, std::istringstream& response)
+{
+    const Shard& shard = m_shards[shardNr];
+    std::vector<PositionRecord> records(shard.count);
+    for (size_t index = 0; index < shard.count; index++)
+    {
+        int column;
+        long long value;
+        int depth;
+        if (!(response >> column >> value >> depth) || column < 0 || column > FIELD_WIDTH)
+            return false;
+
+        PositionRecord& record = records[index];
+        Field field;
+        createField((*m_positions)[shard.first + index], field);
+        record.key = field.getKey();
+        record.score = (int32_t)value;
+        record.move = (uint8_t)column;
+        record.depth = (uint16_t)depth;
+        record.flags = 0;
+        if (column > 0)
+        {
+            record.flags = RECORD_FLAG_EXACT | RECORD_FLAG_ALGORITHM_TO_MOVE;
+            if (value == INT_MAX || value == INT_MIN)
+                record.flags |= RECORD_FLAG_SOLVED;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Shard& storedShard = m_shards[shardNr];
+        if (!storedShard.done)
+        {
+            std::copy(records.begin(), records.end(), m_results->begin() + storedShard.first);
+            storedShard.done = true;
+            m_openShards--;
+        }
+    }
+    m_condition.notify_all();
+
+    return true;
+}
+
+/**
+ * Indicates if all shards are done. The mutex has to be locked.
+ *
+ * \return Returns true if every shard was analysed or has failed.
+ */
+bool Coordinator::isFinished()
+{
+    return m_openShards == 0;
+}
+
+/**
+ * Waits until all shards are done. Local workers that ended are started again while there is work left. If no local
+ * worker is running anymore and none may be started, the remaining shards fail.
+ *
+ */
+void Coordinator::superviseWorkers()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!isFinished())
+    {
+        m_condition.wait_for(lock, std::chrono::milliseconds(100));
+        if (m_processes.empty() || isFinished())
+            continue;
+
+        bool running = false;
+        for (std::unique_ptr<Process>& process : m_processes)
+        {
+            if (!process->isRunning() && m_report.restartedWorkers < m_options.maxRestarts)
+            {
+                process.reset(new Process());
+                if (startWorker(*process))
+                    m_report.restartedWorkers++;
+            }
+
+            running |= process->isRunning();
+        }
+
+        if (!running)
+        {
+            for (size_t shardNr : m_pendingShards)
+            {
+                m_shards[shardNr].done = true;
+                m_report.failedShards++;
+            }
+            m_openShards -= m_pendingShards.size();
+            m_pendingShards.clear();
+        }
+    }
+}
+
+/**
+ * Starts a local worker that connects to this coordinator.
+ *
+ * \param process The process to start.
+ * \return Returns true if the operation was successful.
+ */
+bool Coordinator::startWorker(Process& process)
+{
+    std::vector<std::string> arguments = { "worker", "--host", m_options.host, "--port", std::to_string(port()),
+        "--memory", std::to_string(m_options.memoryBudgetMb) };
+    arguments.insert(arguments.end(), m_options.workerArguments.begin(), m_options.workerArguments.end());
+    return process.start(m_options.executable, arguments);
+}
@@ -0,0 +1,99 @@
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Engine.h"
+#include "Process.h"
+#include "RecordFile.h"
+#include "Socket.h"
+
+// Splits a set of positions into shards and lets AnalysisWorker processes analyse them. Workers connect over TCP, so
+// they can run on this machine or on any other host. Every worker asks for work and gets one shard at a time:
+//  worker:         READY
+//  coordinator:    SHARD <id> <budget ms> <moves> [<moves>]...
+//  worker:         RESULT <id> <column> <value> <depth> [<column> <value> <depth>]...
+//  coordinator:    SHARD ... or QUIT
+// Positions are given by their moves from the empty field, e.g. "4453", "-" stands for the empty field. The player to
+// move is always the algorithm. If a worker disconnects before it answers, its shard is queued again. Local workers
+// that ended are started again as long as there is work left.
+class Coordinator
+{
+public:
+    struct Options
+    {
+        std::string     host                = "127.0.0.1";
+        uint16_t        port                = 0;        // 0 picks a free port
+        int             workers             = 0;        // Local worker processes, 0 uses one per core
+        std::string     executable;                     // Program of the local workers. Empty starts no workers.
+        std::vector<std::string> workerArguments;       // Added to the arguments of the local workers
+        size_t          shardSize           = 16;
+        int             timeBudgetMs        = 100;      // Per position
+        size_t          memoryBudgetMb      = ENGINE_DEFAULT_MEMORY_BUDGET_MB;     // Per worker
+        int             maxAttempts         = 3;        // Per shard
+        int             maxRestarts         = 16;       // Of all local workers together
+    };
+
+    struct Report
+    {
+        size_t          positions           = 0;
+        size_t          shards              = 0;
+        size_t          requeuedShards      = 0;
+        size_t          failedShards        = 0;
+        int             restartedWorkers    = 0;
+        double          seconds             = 0;
+    };
+
+    Coordinator(const Options& options);
+    ~Coordinator();
+
+    bool run(const std::vector<std::string>& positions, std::vector<PositionRecord>& results, Report& report);
+    uint16_t port();
+
+    static bool readPositions(const std::string& path, std::vector<std::string>& positions);
+    static void expandFrontier(int depth, std::vector<std::string>& positions);
+    static void printReport(const Report& report);
+
+private:
+    struct Shard
+    {
+        size_t          first       = 0;
+        size_t          count       = 0;
+        int             attempts    = 0;
+        bool            done        = false;
+    };
+
+    void acceptWorkers();
+    void serveWorker(std::shared_ptr<Socket> connection);
+    bool takeShard(size_t& shardNr);
+    void returnShard(size_t shardNr);
+    bool storeResult(size_t shardNr, std::istringstream& response);
+    bool isFinished();
+    void superviseWorkers();
+    bool startWorker(Process& process);
+
+    Options                                 m_options;
+    Socket                                  m_listener;
+    std::vector<std::unique_ptr<Process>>   m_processes;
+    std::thread                             m_acceptThread;
+    std::vector<std::thread>                m_workerThreads;
+    const std::vector<std::string>*         m_positions     = nullptr;
+    std::vector<PositionRecord>*            m_results       = nullptr;
+    std::vector<Shard>                      m_shards;
+    std::deque<size_t>                      m_pendingShards;
+    size_t                                  m_openShards    = 0;
+    Report                                  m_report;
+    bool                                    m_stopping      = false;
+    std::mutex                              m_mutex;
+    std::condition_variable                 m_condition;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#include "Algorithm.h"
+#include "CustomDefines.h"
+#include "Engine.h"
+#include "MonteCarlo.h"
+
+/**
+ * Sets the transposition table the engine uses. Engines that have no use for a transposition table ignore it.
+ *
+ * \param table The table to use. nullptr disables the transposition table.
+ */
+void Engine::setTranspositionTable(std::shared_ptr<TranspositionTable> table)
+{
+    UNUSED(table);
+}
+
+/**
+ * Creates an engine by its name.
+ *
+ * \param name The name of the engine, see Engine::names.
+ * \param threadCount The number of threads of engines that search with several threads. 0 uses one thread per core.
+ * Callers that run several engines at the same time have to split the cores between them.
+ * \return Returns the new engine or nullptr if there is no engine with this name.
+ */
+std::unique_ptr<Engine> Engine::create(const std::string& name, int threadCount)
+{
+    if (name == "minimax")
+        return std::unique_ptr<Engine>(new Algorithm());
+    else if (name == "mcts")
+        return std::unique_ptr<Engine>(new MonteCarlo(threadCount));
+
+    return nullptr;
+}
+
+/**
+ * Gives info about all engines that can be created.
+ *
+ * \return Returns the names of all engines.
+ */
+std::vector<std::string> Engine::names()
+{
+    return { "minimax", "mcts" };
+}
@@ -0,0 +1,29 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Field.h"
+#include "TranspositionTable.h"
+
+// Memory an engine may use for its tree, pools and caches if no other budget is set.
+constexpr size_t ENGINE_DEFAULT_MEMORY_BUDGET_MB = 128;
+
+// Common interface of all search engines. An engine always plays the stones of Field::Player::Algorithm and the human
+// made the last move.
+class Engine
+{
+public:
+    virtual ~Engine() = default;
+
+    virtual std::string name() = 0;
+    virtual int getNextMove(Field field, int timeBudgetMs = 0) = 0;
+    virtual void setTranspositionTable(std::shared_ptr<TranspositionTable> table);
+    virtual void setMemoryBudget(size_t megabytes) = 0;
+
+    static std::unique_ptr<Engine> create(const std::string& name, int threadCount = 0);
+    static std::vector<std::string> names();
+};
+
+#endif
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Algorithm.h"
+#include "CustomDefines.h"
+#include "EngineApi.h"
+#include "Node.h"
+
+// Transposition table of a new context in MB, the size of TRANSPOSITION_TABLE_DEFAULT_SIZE.
+constexpr int64_t C4_DEFAULT_TABLE_MB = 16;
+
+// Everything a context owns. The engines are created by the first search after an option changed, so setting
+// several options in a row does not allocate anything.
+struct c4_context
+{
+    int64_t                                 timeBudgetMs    = 0;
+    int64_t                                 memoryMb        = ENGINE_DEFAULT_MEMORY_BUDGET_MB;
+    int64_t                                 tableMb         = C4_DEFAULT_TABLE_MB;
+    int64_t                                 proofNodes      = DEFAULT_PROOF_NODE_BUDGET;
+    int64_t                                 threads         = 1;
+    std::shared_ptr<TranspositionTable>     table;
+    std::shared_ptr<EvaluationCache>        evaluationCache;
+    std::vector<std::unique_ptr<Algorithm>> algorithms;
+};
+
+/**
+ * Helper function to get the number of threads a batch is split over.
+ *
+ * \param context The context.
+ * \return Returns the number of threads.
+ */
+static size_t getThreadCount(c4_context* context)
+{
+    return context->threads > 0 ? (size_t)context->threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * Helper function to create the engines of a context after its options changed. Every thread gets its own engine,
+ * all of them share the transposition table and the evaluation cache.
+ *
+ * \param context The context.
+ */
+static void prepareEngines(c4_context* context)
+{
+    if (!context->algorithms.empty())
+        return;
+
+    if (!context->table && context->tableMb > 0)
+    {
+        context->table = std::make_shared<TranspositionTable>(
+            TranspositionTable::entriesForBudget((size_t)context->tableMb));
+    }
+
+    if (!context->evaluationCache)
+        context->evaluationCache = std::make_shared<EvaluationCache>();
+
+    for (size_t threadNr = 0; threadNr < getThreadCount(context); threadNr++)
+    {
+        std::unique_ptr<Algorithm> algorithm = std::make_unique<Algorithm>();
+        algorithm->setTranspositionTable(context->table);
+        algorithm->setEvaluationCache(context->evaluationCache);
+        algorithm->setMemoryBudget((size_t)context->memoryMb);
+        algorithm->setProofNodeBudget((uint64_t)context->proofNodes);
+        context->algorithms.push_back(std::move(algorithm));
+    }
+}
+
+/**
+ * Helper function to run a task for every position of a batch. The batch is split into one contiguous part per
+ * thread, the first part runs on the calling thread. Exceptions must not leave the threads, so running out of memory
+ * is reported by the return value.
+ *
+ * \param threads The number of threads.
+ * \param count The number of positions.
+ * \param task Is called with the number of the part and the index of the position.
+ * \return Returns false if a task ran out of memory.
+ */
+static bool forEachPosition(size_t threads, size_t count, const std::function<void(size_t, size_t)>& task)
+{
+    size_t parts = std::min(threads, count);
+    if (parts == 0)
+        return true;
+
+    size_t partSize = (count + parts - 1) / parts;
+    std::atomic<bool> outOfMemory(false);
+    auto runPart = [&](size_t partNr) {
+        try
+        {
+            size_t end = std::min(count, (partNr + 1) * partSize);
+            for (size_t index = partNr * partSize; index < end; index++)
+                task(partNr, index);
+        }
+        catch (const std::bad_alloc&)
+        {
+            outOfMemory = true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t partNr = 1; partNr < parts; partNr++)
+        workers.emplace_back(runPart, partNr);
+
+    runPart(0);
+    for (std::thread& worker : workers)
+        worker.join();
+
+    return !outOfMemory;
+}
+
+/**
+ * Helper function to evaluate a field without searching, like a leaf of the tree.
+ *
+ * \param field The field. The algorithm is the player to move.
+ * \return Returns the value seen from the algorithm, see Node::getNodeValue.
+ */
+static int evaluateField(const Field& field)
+{
+    Node node;
+    node.init(field, Field::Player::Human);
+    node.evaluateState();
+    return node.getNodeValue();
+}
+
+/**
+ * Creates a context with the default options.
+ *
+ * \return Returns the context or NULL if there is not enough memory. It has to be freed with c4_destroy.
+ */
+c4_context* c4_create(void)
+{
+    return new (std::nothrow) c4_context();
+}
+
+/**
+ * Frees a context.
+ *
+ * \param context The context. NULL is ignored.
+ */
+void c4_destroy(c4_context* context)
+{
+    delete context;
+}
+
+/**
+ * Sets an option of a context. The option applies to all following batches.
+ *
+ * \param context The context.
+ * \param option The option, see c4_option.
+ * \param value The new value. Negative values are invalid, budgets have to be at least 1 MB.
+ * \return Returns C4_OK, C4_ERROR_UNKNOWN_OPTION or C4_ERROR_INVALID_ARGUMENT.
+ */
+int c4_set_option(c4_context* context, c4_option option, int64_t value)
+{
+    if (!context || value < 0)
+        return C4_ERROR_INVALID_ARGUMENT;
+
+    switch (option)
+    {
+    case C4_OPTION_TIME_BUDGET_MS:
+        if (value > INT_MAX)
+            return C4_ERROR_INVALID_ARGUMENT;
+        context->timeBudgetMs = value;
+        return C4_OK;
+    case C4_OPTION_MEMORY_MB:
+        if (value == 0)
+            return C4_ERROR_INVALID_ARGUMENT;
+        context->memoryMb = value;
+        break;
+    case C4_OPTION_TABLE_MB:
+        context->tableMb = value;
+        context->table.reset();
+        break;
+    case C4_OPTION_PROOF_NODES:
+        context->proofNodes = value;
+        break;
+    case C4_OPTION_THREADS:
+        context->threads = value;
+        break;
+    default:
+        return C4_ERROR_UNKNOWN_OPTION;
+    }
+
+    context->algorithms.clear();
+    return C4_OK;
+}
+
+/**
+ * Builds the key of a position from its moves. The key is seen from the player to move, so it can be passed to
+ * c4_evaluate and c4_search directly.
+ *
+ * \param moves The columns of the moves from the empty field, starting at 1, e.g. "4453". "" is the empty field.
+ * \param key Receives the key.
+ * \return Returns C4_OK or C4_ERROR_INVALID_ARGUMENT if a move is invalid or the game was already over.
+ */
+int c4_key_from_moves(const char* moves, uint64_t* key)
+{
+    if (!moves || !key)
+        return C4_ERROR_INVALID_ARGUMENT;
+
+    std::string moveString(moves);
+    Field field;
+    Field::Player firstPlayer = moveString.size() % 2 == 0 ? Field::Player::Algorithm : Field::Player::Human;
+    if (!field.placeStones(moveString, firstPlayer))
+        return C4_ERROR_INVALID_ARGUMENT;
+
+    *key = field.getKey();
+    return C4_OK;
+}
+
+/**
+ * Evaluates a batch of positions without searching them. This is the evaluation the search uses for its leaves.
+ *
+ * \param context The context.
+ * \param keys The keys of the positions.
+ * \param count The number of positions.
+ * \param scores Receives one score per position, seen from the player to move. Won and lost positions get
+ * C4_SCORE_WIN and C4_SCORE_LOSS.
+ * \return Returns C4_OK, C4_ERROR_OUT_OF_MEMORY or C4_ERROR_INVALID_ARGUMENT if an argument or a key is invalid. The
+ * scores of invalid keys are 0, all other positions are evaluated anyway.
+ */
+int c4_evaluate(c4_context* context, const uint64_t* keys, size_t count, int32_t* scores)
+{
+    if (!context || (count > 0 && (!keys || !scores)))
+        return C4_ERROR_INVALID_ARGUMENT;
+
+    std::atomic<bool> invalidKey(false);
+    bool success = forEachPosition(getThreadCount(context), count, [&](size_t partNr, size_t index) {
+        UNUSED(partNr);
+        Field field;
+        if (!field.setKey(keys[index]))
+        {
+            scores[index] = 0;
+            invalidKey = true;
+            return;
+        }
+
+        scores[index] = evaluateField(field);
+    });
+
+    if (!success)
+        return C4_ERROR_OUT_OF_MEMORY;
+
+    return invalidKey ? C4_ERROR_INVALID_ARGUMENT : C4_OK;
+}
+
+/**
+ * Searches a batch of positions with the minimax engine. The positions are split over the threads of the context.
+ *
+ * \param context The context.
+ * \param keys The keys of the positions.
+ * \param count The number of positions.
+ * \param moves Receives the best move per position. Columns start at 1, 0 means that the game is already over.
+ * \param scores Receives the value of the best move, seen from the player to move. Can be NULL.
+ * \return Returns C4_OK, C4_ERROR_OUT_OF_MEMORY or C4_ERROR_INVALID_ARGUMENT if an argument or a key is invalid. The
+ * moves and scores of invalid keys are 0, all other positions are searched anyway.
+ */
+int c4_search(c4_context* context, const uint64_t* keys, size_t count, int32_t* moves, int32_t* scores)
+{
+    if (!context || (count > 0 && (!keys || !moves)))
+        return C4_ERROR_INVALID_ARGUMENT;
+
+    try
+    {
+        prepareEngines(context);
+    }
+    catch (const std::bad_alloc&)
+    {
+        context->algorithms.clear();
+        return C4_ERROR_OUT_OF_MEMORY;
+    }
+
+    std::atomic<bool> invalidKey(false);
+    bool success = forEachPosition(context->algorithms.size(), count, [&](size_t partNr, size_t index) {
+        Field field;
+        int move = 0;
+        int score = 0;
+        if (!field.setKey(keys[index]))
+            invalidKey = true;
+        else if (field.isGameOver())
+            score = evaluateField(field);
+        else
+        {
+            Algorithm& algorithm = *context->algorithms[partNr];
+            move = algorithm.getNextMove(field, (int)context->timeBudgetMs);
+            score = algorithm.getBestValue();
+        }
+
+        moves[index] = move;
+        if (scores)
+            scores[index] = score;
+    });
+
+    if (!success)
+        return C4_ERROR_OUT_OF_MEMORY;
+
+    return invalidKey ? C4_ERROR_INVALID_ARGUMENT : C4_OK;
+}
@@ -0,0 +1,70 @@
+#ifndef ENGINEAPI_H
+#define ENGINEAPI_H
+
+/*
+ * C interface of the connect_4_engine shared library. It embeds the minimax engine into other programs and languages
+ * without the console game. All functions work on batches: the positions are passed as a contiguous array of packed
+ * keys and the results are written into arrays of the caller, so a batch of any size costs a single call.
+ *
+ * Keys have the layout of Field::getKey (see KEY_COLUMN_BITS). The engine always plays the stones that the key marks
+ * as the algorithm's, i.e. the key has to be seen from the player to move. c4_key_from_moves builds such keys.
+ *
+ * A context may only be used by one thread at a time. Different contexts are independent.
+ *
+ * The library has to be built with C4_BUILD_LIBRARY defined. It starts no threads that outlive a call, so it can be
+ * unloaded whenever no call is running.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#   if defined(C4_BUILD_LIBRARY)
+#       define C4_API __declspec(dllexport)
+#   elif defined(C4_STATIC)
+#       define C4_API
+#   else
+#       define C4_API __declspec(dllimport)
+#   endif
+#else
+#   define C4_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Return codes. */
+#define C4_OK                       0
+#define C4_ERROR_INVALID_ARGUMENT   -1
+#define C4_ERROR_UNKNOWN_OPTION     -2
+#define C4_ERROR_OUT_OF_MEMORY      -3
+
+/* Scores of won and lost positions, seen from the player to move. */
+#define C4_SCORE_WIN                INT32_MAX
+#define C4_SCORE_LOSS               INT32_MIN
+
+typedef struct c4_context c4_context;
+
+typedef enum c4_option
+{
+    C4_OPTION_TIME_BUDGET_MS    = 1,    /* Per searched position, 0 searches the full depth (default) */
+    C4_OPTION_MEMORY_MB         = 2,    /* Tree memory per thread, default ENGINE_DEFAULT_MEMORY_BUDGET_MB */
+    C4_OPTION_TABLE_MB          = 3,    /* Transposition table shared by all threads, 0 disables it (default 16) */
+    C4_OPTION_PROOF_NODES       = 4,    /* Proof-number search before every search, 0 disables it */
+    C4_OPTION_THREADS           = 5     /* Threads a batch is split over, 0 uses one per core (default 1) */
+} c4_option;
+
+C4_API c4_context* c4_create(void);
+C4_API void c4_destroy(c4_context* context);
+C4_API int c4_set_option(c4_context* context, c4_option option, int64_t value);
+
+C4_API int c4_key_from_moves(const char* moves, uint64_t* key);
+C4_API int c4_evaluate(c4_context* context, const uint64_t* keys, size_t count, int32_t* scores);
+C4_API int c4_search(c4_context* context, const uint64_t* keys, size_t count, int32_t* moves, int32_t* scores);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
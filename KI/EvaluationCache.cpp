@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include "EvaluationCache.h"
+
+static_assert(sizeof(std::atomic<uint64_t>) == EVALUATION_CACHE_ENTRY_BYTES, "Unexpected entry size");
+
+/**
+ * Helper function to spread the packed keys, whose lower bits are mostly zero, over the whole cache. The function is
+ * a bijection, so the lower bits select the entry and the upper bits identify the key inside of it.
+ *
+ * \param key The key to hash.
+ * \return Returns the hashed key.
+ */
+static uint64_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * Helper function to get the tag that identifies a key inside of its entry. The lowest bit of the tag is always set,
+ * so a tag is never 0 and an empty entry does not match any key. That leaves 31 bits of the hash in the tag.
+ *
+ * \param hash The hashed key.
+ * \return Returns the tag in the upper 32 bits.
+ */
+static uint64_t getTag(uint64_t hash)
+{
+    return (hash | (uint64_t(1) << 32)) & 0xFFFFFFFF00000000ULL;
+}
+
+/**
+ * Public constructor.
+ *
+ * \param size The number of entries. It is rounded down to a power of two.
+ */
+EvaluationCache::EvaluationCache(size_t size)
+{
+    size_t roundedSize = 1;
+    while (roundedSize * 2 <= size)
+        roundedSize *= 2;
+
+    m_entries.reset(new std::atomic<uint64_t>[roundedSize]);
+    m_mask = roundedSize - 1;
+    clear();
+}
+
+/**
+ * Looks up the evaluation of a field. Two keys are only told apart by the 31 bits of their hash in the tag, so about
+ * one in two billion lookups of a missing field returns the value of another one, which is harmless for a heuristic.
+ * This method can be called from multiple threads at the same time.
+ *
+ * \param key The packed key of the field, see Field::getKey.
+ * \param value Receives the evaluation, if it was found.
+ * \return Returns true if the evaluation was found.
+ */
+bool EvaluationCache::probe(uint64_t key, int& value)
+{
+    uint64_t hash = hashKey(key);
+    uint64_t entry = m_entries[hash & m_mask].load(std::memory_order_relaxed);
+    if ((entry & 0xFFFFFFFF00000000ULL) != getTag(hash))
+        return false;
+
+    // Layout: |tag 31 bit|1|value 32 bit|
+    value = static_cast<int32_t>(static_cast<uint32_t>(entry));
+    return true;
+}
+
+/**
+ * Stores the evaluation of a field. The entry that was there before is replaced. This method can be called from
+ * multiple threads at the same time.
+ *
+ * \param key The packed key of the field, see Field::getKey.
+ * \param value The evaluation.
+ */
+void EvaluationCache::store(uint64_t key, int value)
+{
+    uint64_t hash = hashKey(key);
+    m_entries[hash & m_mask].store(getTag(hash) | static_cast<uint32_t>(value), std::memory_order_relaxed);
+}
+
+/**
+ * Removes all entries. Must not be called while a search uses the cache.
+ *
+ */
+void EvaluationCache::clear()
+{
+    for (size_t index = 0; index <= m_mask; index++)
+        m_entries[index].store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Gives info about the size of the cache.
+ *
+ * \return Returns the number of entries.
+ */
+size_t EvaluationCache::size()
+{
+    return m_mask + 1;
+}
+
+/**
+ * Gives info about the share of lookups that found an evaluation.
+ *
+ * \return Returns the hit rate between 0 and 1. 0 if there were no lookups.
+ */
+double EvaluationCache::Statistics::getHitRate() const
+{
+    uint64_t lookups = hits + misses;
+    return lookups > 0 ? (double)hits / lookups : 0;
+}
+
+/**
+ * Adds the lookups of another search, e.g. to sum up the searches of several threads that share a cache.
+ *
+ * \param other The lookups to add.
+ * \return Returns the statistics themselves.
+ */
+EvaluationCache::Statistics& EvaluationCache::Statistics::operator+=(const Statistics& other)
+{
+    hits += other.hits;
+    misses += other.misses;
+    return *this;
+}
+
+/**
+ * Calculates how many entries fit into a memory budget. The budget is given in bytes, because the cache usually gets a
+ * small share of the budget of an engine.
+ *
+ * \param bytes The memory budget in bytes.
+ * \return Returns the number of entries, at least 1.
+ */
+size_t EvaluationCache::entriesForBudget(size_t bytes)
+{
+    return std::max<size_t>(bytes / EVALUATION_CACHE_ENTRY_BYTES, 1);
+}
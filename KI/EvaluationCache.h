@@ -0,0 +1,46 @@
+#ifndef EVALUATIONCACHE_H
+#define EVALUATIONCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Default number of entries of an evaluation cache, 2 MB.
+constexpr size_t EVALUATION_CACHE_DEFAULT_SIZE = size_t(1) << 18;
+constexpr size_t EVALUATION_CACHE_ENTRY_BYTES = 8;
+
+// Direct-mapped cache of the static evaluation of Node::evaluateState. At the horizon of the search the same position
+// is reached by many orders of moves, and the evaluation does not depend on the player to move, so the packed key of
+// the field is enough to find it. Unlike the TranspositionTable it stores no search results, only the evaluation.
+// Every entry is a single 64 bit word, eight of them share a cache line. Reads and writes are single atomic operations,
+// so several searches can use the same cache at the same time without any locks.
+// The cache does not count its hits itself, every search counts its own lookups in a Statistics. Shared counters
+// would be written by every lookup of every thread.
+class EvaluationCache
+{
+public:
+    struct Statistics
+    {
+        uint64_t    hits        = 0;
+        uint64_t    misses      = 0;
+
+        double getHitRate() const;
+        Statistics& operator+=(const Statistics& other);
+    };
+
+    EvaluationCache(size_t size = EVALUATION_CACHE_DEFAULT_SIZE);
+
+    bool probe(uint64_t key, int& value);
+    void store(uint64_t key, int value);
+    void clear();
+    size_t size();
+
+    static size_t entriesForBudget(size_t bytes);
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]>    m_entries;
+    size_t                                      m_mask;
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "Field.h"
 
 /**
@@ -73,6 +75,12 @@ bool Field::placeStone(int columnNr, Field::Player player)
             else
                 m_fieldState[rowNr][columnNr] = ALGOTITHM_SYMBOL;
 
+            // Keep the packed key in sync, so it can be read without scanning the field.
+            uint64_t stoneBit = uint64_t(1) << (columnNr * KEY_COLUMN_BITS + (FIELD_HEIGHT - 1 - rowNr));
+            m_occupiedMask |= stoneBit;
+            if (player == Player::Algorithm)
+                m_algorithmStones |= stoneBit;
+
             // Check if this move was a winning move
             m_lastMoveColumn = columnNr;
             m_lastMoveRow = rowNr;
@@ -85,6 +93,101 @@ bool Field::placeStone(int columnNr, Field::Player player)
     return false;
 }
 
+/**
+ * Places a sequence of stones. The players take turns, starting with the given one.
+ *
+ * \param moves The columns of the moves as digits from 1 to 7, e.g. "4453".
+ * \param firstPlayer The player that makes the first move.
+ * \return Returns true if all moves could be made. False means, that a character is not a column, a column is full
+ * or the game was over before the last move.
+ */
+bool Field::placeStones(const std::string& moves, Field::Player firstPlayer)
+{
+    Player player = firstPlayer;
+    for (char move : moves)
+    {
+        if (isGameOver() || move < '1' || move > '9' || !placeStone(move - '0', player))
+            return false;
+
+        player = player == Player::Human ? Player::Algorithm : Player::Human;
+    }
+
+    return true;
+}
+
+/**
+ * Replaces the whole field with the position encoded in a packed key. See KEY_COLUMN_BITS for the layout.
+ *
+ * \param key The packed key as returned by Field::getKey.
+ * \return Returns true if the operation was successful. False means, that the key is not valid. The field is left
+ * untouched in that case.
+ */
+bool Field::setKey(uint64_t key)
+{
+    if (key >> (FIELD_WIDTH * KEY_COLUMN_BITS) != 0)
+        return false;
+
+    std::vector<std::vector<char>> fieldState(FIELD_HEIGHT, std::vector<char>(FIELD_WIDTH, FREE_SPACE_SYMBOL));
+    uint64_t algorithmStones = 0;
+    uint64_t occupiedMask = 0;
+    for (int columnNr = 0; columnNr < FIELD_WIDTH; columnNr++)
+    {
+        uint64_t column = (key >> (columnNr * KEY_COLUMN_BITS)) & KEY_COLUMN_MASK;
+
+        // Every column needs its marker bit, everything below it are stones.
+        if (column == 0)
+            return false;
+
+        int stones = 0;
+        while (column >> (stones + 1) != 0)
+            stones++;
+
+        for (int stoneNr = 0; stoneNr < stones; stoneNr++)
+        {
+            uint64_t stoneBit = uint64_t(1) << (columnNr * KEY_COLUMN_BITS + stoneNr);
+            bool algorithmStone = (column >> stoneNr) & 1;
+            fieldState[FIELD_HEIGHT - 1 - stoneNr][columnNr] = algorithmStone ? ALGOTITHM_SYMBOL : HUMAN_SYMBOL;
+            occupiedMask |= stoneBit;
+            if (algorithmStone)
+                algorithmStones |= stoneBit;
+        }
+    }
+
+    m_fieldState = fieldState;
+    m_algorithmStones = algorithmStones;
+    m_occupiedMask = occupiedMask;
+    m_gameState = GameState::Running;
+    m_win = false;
+    m_lastMoveColumn = 0;
+    m_lastMoveRow = 0;
+
+    // The order of the moves is unknown, so every stone has to be checked for a win.
+    for (int rowNr = 0; rowNr < FIELD_HEIGHT && !m_win; rowNr++)
+    {
+        for (int columnNr = 0; columnNr < FIELD_WIDTH && !m_win; columnNr++)
+        {
+            if (m_fieldState[rowNr][columnNr] == FREE_SPACE_SYMBOL)
+                continue;
+
+            m_lastMoveRow = rowNr;
+            m_lastMoveColumn = columnNr;
+            checkWin();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Packs the field into a 64 bit key. See KEY_COLUMN_BITS for the layout.
+ *
+ * \return Returns the packed key of the field.
+ */
+uint64_t Field::getKey()
+{
+    return m_algorithmStones + m_occupiedMask + KEY_BOTTOM_MASK;
+}
+
 /**
  * Gives info about the status of the game.
  * 
@@ -220,7 +323,7 @@ void Field::checkWin()
 
     // Check diagonal top left to bottom right
     groupSize = 1;
-    for (int offset = 1; offset <= __min(maxStepsUp, maxStepsLeft); offset++)
+    for (int offset = 1; offset <= std::min(maxStepsUp, maxStepsLeft); offset++)
     {
         if (m_fieldState[m_lastMoveRow - offset][m_lastMoveColumn - offset] == referenceSymbol)
             groupSize++;
@@ -228,7 +331,7 @@ void Field::checkWin()
             break;
     }
 
-    for (int offset = 1; offset <= __min(maxStepsDown, maxStepsRight); offset++)
+    for (int offset = 1; offset <= std::min(maxStepsDown, maxStepsRight); offset++)
     {
         if (m_fieldState[m_lastMoveRow + offset][m_lastMoveColumn + offset] == referenceSymbol)
             groupSize++;
@@ -246,7 +349,7 @@ void Field::checkWin()
     // Check diagonal top right to bottom left
     groupSize = 1;
 
-    for (int offset = 1; offset <= __min(maxStepsUp, maxStepsRight); offset++)
+    for (int offset = 1; offset <= std::min(maxStepsUp, maxStepsRight); offset++)
     {
         if (m_fieldState[m_lastMoveRow - offset][m_lastMoveColumn + offset] == referenceSymbol)
             groupSize++;
@@ -254,7 +357,7 @@ void Field::checkWin()
             break;
     }
 
-    for (int offset = 1; offset <= __min(maxStepsDown, maxStepsLeft); offset++)
+    for (int offset = 1; offset <= std::min(maxStepsDown, maxStepsLeft); offset++)
     {
         if (m_fieldState[m_lastMoveRow + offset][m_lastMoveColumn - offset] == referenceSymbol)
             groupSize++;
@@ -2,6 +2,8 @@
 #define FIELD_H
 
 #include <vector>
+#include <cstdint>
+#include <string>
 
 constexpr auto FIELD_WIDTH = 7;
 constexpr auto FIELD_HEIGHT = 6;
@@ -10,6 +12,17 @@ constexpr auto HUMAN_SYMBOL = 'X';
 constexpr auto ALGOTITHM_SYMBOL = 'O';
 constexpr auto FREE_SPACE_SYMBOL = ' ';
 
+// Layout of the packed position key. Every column uses FIELD_HEIGHT + 1 bits, starting with the leftmost column at
+// bit 0. Inside a column the lowest bit is the bottom row. The key is the sum of the algorithm's stones, all stones
+// and the bottom row, which sets exactly one marker bit above the topmost stone of every column:
+//  column:  |0 0 0 0 0 1 0|  -> empty column, marker on bit 0
+//  column:  |0 0 0 1 0 1 1|  -> two stones, the bottom one belongs to the algorithm
+// Such a key identifies a field uniquely and fits in 49 bits.
+constexpr auto KEY_COLUMN_BITS = FIELD_HEIGHT + 1;
+constexpr uint64_t KEY_COLUMN_MASK = (uint64_t(1) << KEY_COLUMN_BITS) - 1;
+constexpr uint64_t KEY_BOTTOM_MASK = 0x40810204081ULL;
+static_assert(FIELD_WIDTH * KEY_COLUMN_BITS <= 64, "The packed key does not fit in 64 bits");
+
 class Field
 {
 public:
@@ -33,6 +46,9 @@ public:
     std::vector<char> getColumn(int columnNr);
 
     bool placeStone(int columnNr, Player player);
+    bool placeStones(const std::string& moves, Player firstPlayer);
+    bool setKey(uint64_t key);
+    uint64_t getKey();
     bool isGameOver();
     bool isDraw();
     bool isMovePossible(int columnNr);
@@ -50,6 +66,8 @@ private:
     Player                          m_winner;
     int                             m_lastMoveColumn    = 0;
     int                             m_lastMoveRow       = 0;
+    uint64_t                        m_algorithmStones   = 0;
+    uint64_t                        m_occupiedMask      = 0;
 };
 
 #endif
\ No newline at end of file
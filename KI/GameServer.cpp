@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include "Engine.h"
+#include "GameServer.h"
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the server.
+ */
+GameServer::GameServer(const Options& options) : m_options(options)
+{
+    m_transpositionTable = std::make_shared<TranspositionTable>(
+        TranspositionTable::entriesForBudget(options.memoryBudgetMb / 4));
+}
+
+/**
+ * Destructor. Stops the server.
+ *
+ */
+GameServer::~GameServer()
+{
+    stop();
+}
+
+/**
+ * Starts listening for clients and starts the workers.
+ *
+ * \return Returns true if the operation was successful. False means, that the port could not be opened or the engine
+ * is unknown.
+ */
+bool GameServer::start()
+{
+    m_stopping = false;
+    std::vector<std::string> engineNames = Engine::names();
+    if (std::find(engineNames.begin(), engineNames.end(), m_options.engine) == engineNames.end())
+        return false;
+
+    if (!m_listener.listen(m_options.host, m_options.port))
+        return false;
+
+    m_pool.reset(new ThreadPool(m_options.threads, m_options.maxQueuedSearches));
+    m_engineMemoryBudgetMb = std::max<size_t>(m_options.memoryBudgetMb * 3 / 4 / m_pool->threadCount(), 1);
+
+    // Every worker runs one search at a time, so one engine per worker is enough. The workers already use all cores, so
+    // every engine searches with a single thread. The engines are kept between the searches, so large structures like
+    // the node pool of MonteCarlo are allocated once.
+    std::lock_guard<std::mutex> lock(m_enginesMutex);
+    m_engines.clear();
+    m_freeEngines.clear();
+    for (size_t engineNr = 0; engineNr < m_pool->threadCount(); engineNr++)
+    {
+        m_engines.push_back(Engine::create(m_options.engine, 1));
+        m_engines.back()->setTranspositionTable(m_transpositionTable);
+        m_engines.back()->setMemoryBudget(m_engineMemoryBudgetMb);
+        m_freeEngines.push_back(m_engines.back().get());
+    }
+    return true;
+}
+
+/**
+ * Accepts clients until the server is stopped. Every client gets its own thread that reads its requests, the searches
+ * run on the shared workers. GameServer::start has to be called first.
+ *
+ */
+void GameServer::run()
+{
+    while (!m_stopping)
+    {
+        std::shared_ptr<Socket> socket = std::make_shared<Socket>();
+        if (!m_listener.accept(*socket))
+            break;
+
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        reapConnections();
+
+        std::unique_ptr<Connection> connection(new Connection());
+        connection->socket = socket;
+        connection->thread = std::thread(&GameServer::serveConnection, this, connection.get());
+        m_connections.push_back(std::move(connection));
+    }
+}
+
+/**
+ * Stops the server. Running searches are finished, but their results are not sent anymore.
+ *
+ */
+void GameServer::stop()
+{
+    m_stopping = true;
+    m_listener.shutdown();
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        for (const std::unique_ptr<Connection>& connection : m_connections)
+        {
+            connection->socket->shutdown();
+        }
+        connections.swap(m_connections);
+    }
+
+    for (std::unique_ptr<Connection>& connection : connections)
+    {
+        connection->thread.join();
+    }
+
+    m_pool.reset();
+    m_listener.close();
+
+    std::lock_guard<std::mutex> lock(m_enginesMutex);
+    m_freeEngines.clear();
+    m_engines.clear();
+}
+
+/**
+ * Gives info about the port the server listens on.
+ *
+ * \return Returns the port. This is useful if the server was started with port 0.
+ */
+uint16_t GameServer::port()
+{
+    return m_listener.localPort();
+}
+
+/**
+ * Gives info about the number of open games.
+ *
+ * \return Returns the number of sessions.
+ */
+size_t GameServer::sessionCount()
+{
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    return m_sessions.size();
+}
+
+/**
+ * Converts a game status to the name used by the protocol.
+ *
+ * \param status The status to convert.
+ * \return Returns the name of the status.
+ */
+std::string GameServer::statusName(GameMaster::GameStatus status)
+{
+    switch (status)
+    {
+    case GameMaster::GameStatus::Running:
+        return "RUNNING";
+    case GameMaster::GameStatus::Draw:
+        return "DRAW";
+    case GameMaster::GameStatus::HumanWon:
+        return "HUMAN_WON";
+    default:
+        return "ALGORITHM_WON";
+    }
+}
+
+/**
+ * Reads and answers the requests of a single client until it disconnects.
+ *
+ * \param connection The connection to the client.
+ */
+void GameServer::serveConnection(Connection* connection)
+{
+    std::string request;
+    while (!m_stopping && connection->socket->readLine(request))
+    {
+        if (request.empty())
+            continue;
+
+        std::string response = handleRequest(request, connection->socket);
+        if (!response.empty() && !connection->socket->writeLine(response))
+            break;
+    }
+
+    connection->finished = true;
+}
+
+/**
+ * Helper method to join the threads of clients that disconnected and to free their connections. Searches that are
+ * still running keep their socket until they are done. The caller has to hold the lock of the connections.
+ *
+ */
+void GameServer::reapConnections()
+{
+    auto finished = std::partition(m_connections.begin(), m_connections.end(),
+        [](const std::unique_ptr<Connection>& connection) { return !connection->finished; });
+    for (auto connection = finished; connection != m_connections.end(); connection++)
+        (*connection)->thread.join();
+
+    m_connections.erase(finished, m_connections.end());
+}
+
+/**
+ * Handles a single request. See GameServer for the protocol.
+ *
+ * \param request The request line.
+ * \param connection The connection the request came from. Results of searches are sent there.
+ * \return Returns the response. It is empty if the response will be sent once a search is done.
+ */
+std::string GameServer::handleRequest(const std::string& request, const std::shared_ptr<Socket>& connection)
+{
+    std::istringstream stream(request);
+    std::string tag;
+    std::string command;
+    stream >> tag >> command;
+
+    if (command == "NEW")
+    {
+        std::lock_guard<std::mutex> lock(m_sessionsMutex);
+        if (m_sessions.size() >= m_options.maxSessions)
+            return tag + " ERR too many sessions";
+
+        uint64_t id = m_nextSessionId++;
+        m_sessions[id] = std::make_shared<Session>();
+        return tag + " OK " + std::to_string(id);
+    }
+
+    uint64_t id = 0;
+    if (!(stream >> id))
+        return tag + " ERR invalid request";
+
+    std::shared_ptr<Session> session = findSession(id);
+    if (!session)
+        return tag + " ERR unknown session";
+
+    if (command == "PLAY" || command == "GO")
+    {
+        int column = 0;
+        if (command == "PLAY" && !(stream >> column))
+            return tag + " ERR invalid request";
+
+        int timeBudgetMs = m_options.defaultTimeBudgetMs;
+        stream >> timeBudgetMs;
+        timeBudgetMs = std::min(std::max(timeBudgetMs, 1), m_options.maxTimeBudgetMs);
+        return startSearch(tag, session, column, timeBudgetMs, connection);
+    }
+    else if (command == "STATE")
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        return tag + " OK " + std::to_string(session->gameMaster.getField().getKey()) + " "
+            + statusName(session->gameMaster.getStatus());
+    }
+    else if (command == "CLOSE")
+    {
+        std::lock_guard<std::mutex> lock(m_sessionsMutex);
+        m_sessions.erase(id);
+        return tag + " OK";
+    }
+
+    return tag + " ERR unknown command";
+}
+
+/**
+ * Plays the move of the human and queues the search for the answer of the algorithm.
+ *
+ * \param tag The tag of the request.
+ * \param session The session to play in.
+ * \param humanColumn The column of the human move. 0 means, that the algorithm moves without a human move before.
+ * \param timeBudgetMs The time budget of the request. The time the search waits for a worker is part of it.
+ * \param connection The connection the result is sent to.
+ * \return Returns the response if it can be given right away, e.g. because the human move ended the game.
+ * Otherwise it is empty.
+ */
+std::string GameServer::startSearch(const std::string& tag, std::shared_ptr<Session> session, int humanColumn,
+    int timeBudgetMs, const std::shared_ptr<Socket>& connection)
+{
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->searching)
+        return tag + " ERR search already running";
+
+    GameMaster gameMaster = session->gameMaster;
+    if (gameMaster.getStatus() != GameMaster::GameStatus::Running)
+        return tag + " ERR game is over";
+
+    if (humanColumn != 0 && !gameMaster.playMove(humanColumn, Field::Player::Human))
+        return tag + " ERR invalid move";
+
+    if (gameMaster.getStatus() != GameMaster::GameStatus::Running)
+    {
+        session->gameMaster = gameMaster;
+        return tag + " OK 0 " + statusName(gameMaster.getStatus());
+    }
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+        + std::chrono::milliseconds(timeBudgetMs);
+    Field field = gameMaster.getField();
+
+    bool queued = m_pool->submit([this, tag, session, connection, deadline, field]() {
+        int remainingMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+
+        Engine* engine = acquireEngine();
+        int move = engine->getNextMove(field, std::max(remainingMs, 1));
+        releaseEngine(engine);
+
+        std::string response;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->gameMaster.playMove(move, Field::Player::Algorithm);
+            session->searching = false;
+            response = tag + " OK " + std::to_string(move) + " " + statusName(session->gameMaster.getStatus());
+        }
+        connection->writeLine(response);
+    });
+
+    if (!queued)
+        return tag + " BUSY";
+
+    // The session is locked, so the search can not finish before the human move is stored.
+    session->gameMaster = gameMaster;
+    session->searching = true;
+    return "";
+}
+
+/**
+ * Helper method to find a session.
+ *
+ * \param id The id of the session.
+ * \return Returns the session or nullptr if there is none with this id.
+ */
+std::shared_ptr<GameServer::Session> GameServer::findSession(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    auto session = m_sessions.find(id);
+    if (session == m_sessions.end())
+        return nullptr;
+
+    return session->second;
+}
+
+/**
+ * Helper method to take an engine for a search. There are as many engines as workers, so there always is a free one.
+ *
+ * \return Returns the engine. It has to be given back with GameServer::releaseEngine.
+ */
+Engine* GameServer::acquireEngine()
+{
+    std::lock_guard<std::mutex> lock(m_enginesMutex);
+    Engine* engine = m_freeEngines.back();
+    m_freeEngines.pop_back();
+    return engine;
+}
+
+/**
+ * Helper method to give back an engine after its search.
+ *
+ * \param engine The engine from GameServer::acquireEngine.
+ */
+void GameServer::releaseEngine(Engine* engine)
+{
+    std::lock_guard<std::mutex> lock(m_enginesMutex);
+    m_freeEngines.push_back(engine);
+}
@@ -0,0 +1,99 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine.h"
+#include "GameMaster.h"
+#include "Socket.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+
+// Hosts many games at the same time. Clients talk to the server over TCP with one request per line:
+//  <tag> NEW                                   -> <tag> OK <session>
+//  <tag> PLAY <session> <column> [budget ms]   -> <tag> OK <algorithm column> <status>
+//  <tag> GO <session> [budget ms]              -> <tag> OK <algorithm column> <status>
+//  <tag> STATE <session>                       -> <tag> OK <key> <status>
+//  <tag> CLOSE <session>                       -> <tag> OK
+// The tag is chosen by the client and sent back with the response, because the responses of PLAY and GO are sent as
+// soon as the search is done, which can be after responses to later requests. Errors are reported as
+// "<tag> ERR <message>" and "<tag> BUSY" means, that all workers are busy and the request should be sent again later.
+// <status> is one of RUNNING, DRAW, HUMAN_WON and ALGORITHM_WON. The algorithm column is 0 if the game ended before
+// the algorithm could move.
+// A quarter of the memory budget goes to the shared transposition table, the rest is split between the engines of
+// the workers.
+class GameServer
+{
+public:
+    struct Options
+    {
+        std::string     host                        = "127.0.0.1";
+        uint16_t        port                        = 4444;
+        std::string     engine                      = "minimax";    // See Engine::names
+        size_t          threads                     = 0;            // 0 uses one worker per core
+        size_t          maxQueuedSearches           = 1024;
+        size_t          maxSessions                 = 10000;
+        int             defaultTimeBudgetMs         = 1000;
+        int             maxTimeBudgetMs             = 10000;
+        size_t          memoryBudgetMb              = 1024;     // Shared by the table and all workers
+    };
+
+    GameServer(const Options& options);
+    ~GameServer();
+
+    bool start();
+    void run();
+    void stop();
+    uint16_t port();
+    size_t sessionCount();
+
+    static std::string statusName(GameMaster::GameStatus status);
+
+private:
+    struct Session
+    {
+        std::mutex      mutex;
+        GameMaster      gameMaster;
+        bool            searching       = false;
+    };
+
+    struct Connection
+    {
+        std::shared_ptr<Socket>     socket;
+        std::thread                 thread;
+        std::atomic<bool>           finished{ false };  // The thread is done and can be joined
+    };
+
+    void serveConnection(Connection* connection);
+    void reapConnections();
+    std::string handleRequest(const std::string& request, const std::shared_ptr<Socket>& connection);
+    std::string startSearch(const std::string& tag, std::shared_ptr<Session> session, int humanColumn, int timeBudgetMs,
+        const std::shared_ptr<Socket>& connection);
+    std::shared_ptr<Session> findSession(uint64_t id);
+    Engine* acquireEngine();
+    void releaseEngine(Engine* engine);
+
+    Options                                                     m_options;
+    size_t                                                      m_engineMemoryBudgetMb  = 0;
+    Socket                                                      m_listener;
+    std::shared_ptr<TranspositionTable>                         m_transpositionTable;
+    std::unique_ptr<ThreadPool>                                 m_pool;
+    std::vector<std::unique_ptr<Engine>>                        m_engines;          // One per worker
+    std::vector<Engine*>                                        m_freeEngines;
+    std::mutex                                                  m_enginesMutex;
+    std::unordered_map<uint64_t, std::shared_ptr<Session>>      m_sessions;
+    std::mutex                                                  m_sessionsMutex;
+    uint64_t                                                    m_nextSessionId     = 1;
+    std::vector<std::unique_ptr<Connection>>                    m_connections;
+    std::mutex                                                  m_connectionsMutex;
+    std::atomic<bool>                                           m_stopping{ false };
+};
+
+#endif
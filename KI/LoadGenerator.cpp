@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "GameMaster.h"
+#include "LoadGenerator.h"
+#include "Socket.h"
+
+/**
+ * Helper function to read a percentile from sorted values.
+ *
+ * \param sortedValues The values in ascending order.
+ * \param percentile The percentile between 0 and 100.
+ * \return Returns the value at the percentile. 0 if there are no values.
+ */
+static double percentile(const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+        return 0;
+
+    size_t index = static_cast<size_t>(percentile / 100.0 * (sortedValues.size() - 1) + 0.5);
+    return sortedValues[std::min(index, sortedValues.size() - 1)];
+}
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the load.
+ */
+LoadGenerator::LoadGenerator(const Options& options) : m_options(options)
+{
+}
+
+/**
+ * Plays games on the server until the configured duration is over. Every connection plays its sessions at the same
+ * time, so there are connections * sessionsPerConnection moves waiting for the server most of the time.
+ *
+ * \param report Receives the measurements.
+ * \return Returns true if the operation was successful. False means, that a connection to the server failed.
+ */
+bool LoadGenerator::run(Report& report)
+{
+    report = Report();
+    std::vector<double> latencies;
+    std::mutex reportMutex;
+    bool success = true;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int connectionNr = 0; connectionNr < m_options.connections; connectionNr++)
+    {
+        threads.emplace_back([&, connectionNr]() {
+            std::vector<double> connectionLatencies;
+            Report connectionReport;
+            bool connectionSuccess = runConnection(m_options.seed + connectionNr, connectionLatencies,
+                connectionReport);
+
+            std::lock_guard<std::mutex> lock(reportMutex);
+            latencies.insert(latencies.end(), connectionLatencies.begin(), connectionLatencies.end());
+            report.moves += connectionReport.moves;
+            report.games += connectionReport.games;
+            report.busyResponses += connectionReport.busyResponses;
+            report.errors += connectionReport.errors;
+            success = success && connectionSuccess;
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::sort(latencies.begin(), latencies.end());
+    report.p50Ms = percentile(latencies, 50);
+    report.p99Ms = percentile(latencies, 99);
+    report.maxMs = latencies.empty() ? 0 : latencies.back();
+    return success;
+}
+
+/**
+ * Prints a report to the console.
+ *
+ * \param report The report to print.
+ */
+void LoadGenerator::printReport(const Report& report)
+{
+    std::cout << "moves:        " << report.moves << " (" << report.moves / std::max(report.seconds, 0.001)
+        << " per second)" << std::endl
+        << "games:        " << report.games << std::endl
+        << "busy:         " << report.busyResponses << std::endl
+        << "errors:       " << report.errors << std::endl
+        << "latency p50:  " << report.p50Ms << " ms" << std::endl
+        << "latency p99:  " << report.p99Ms << " ms" << std::endl
+        << "latency max:  " << report.maxMs << " ms" << std::endl;
+}
+
+/**
+ * Plays the sessions of a single connection. The tag of every request is the index of the session it belongs to.
+ *
+ * \param seed Seed for the random human moves.
+ * \param latencies Receives the time between sending every move and receiving the answer in milliseconds.
+ * \param report Receives the counters of the connection.
+ * \return Returns true if the operation was successful.
+ */
+bool LoadGenerator::runConnection(uint32_t seed, std::vector<double>& latencies, Report& report)
+{
+    enum class State
+    {
+        Opening,
+        Playing,
+        Closing,
+        Done
+    };
+
+    struct ClientSession
+    {
+        State                                   state           = State::Opening;
+        std::string                             id;
+        GameMaster                              gameMaster;
+        int                                     pendingColumn   = 0;
+        std::chrono::steady_clock::time_point   sentAt;
+    };
+
+    Socket socket;
+    if (!socket.connect(m_options.host, m_options.port))
+        return false;
+
+    std::mt19937 random(seed);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now()
+        + std::chrono::seconds(m_options.durationSeconds);
+    std::vector<ClientSession> sessions(m_options.sessionsPerConnection);
+
+    auto sendPlay = [&](size_t index, bool newColumn) {
+        ClientSession& session = sessions[index];
+        if (newColumn)
+        {
+            Field field = session.gameMaster.getField();
+            do
+            {
+                session.pendingColumn = (int)(random() % field.width()) + 1;
+            } while (!field.isMovePossible(session.pendingColumn));
+        }
+
+        session.state = State::Playing;
+        session.sentAt = std::chrono::steady_clock::now();
+        return socket.writeLine(std::to_string(index) + " PLAY " + session.id + " "
+            + std::to_string(session.pendingColumn) + " " + std::to_string(m_options.timeBudgetMs));
+    };
+    auto sendClose = [&](size_t index) {
+        sessions[index].state = State::Closing;
+        return socket.writeLine(std::to_string(index) + " CLOSE " + sessions[index].id);
+    };
+
+    for (size_t index = 0; index < sessions.size(); index++)
+    {
+        if (!socket.writeLine(std::to_string(index) + " NEW"))
+            return false;
+    }
+
+    size_t openSessions = sessions.size();
+    std::string line;
+    while (openSessions > 0 && socket.readLine(line))
+    {
+        std::istringstream stream(line);
+        size_t index = 0;
+        std::string result;
+        stream >> index >> result;
+        if (index >= sessions.size())
+            return false;
+
+        ClientSession& session = sessions[index];
+        bool timeIsUp = std::chrono::steady_clock::now() >= end;
+        bool sent = true;
+
+        if (result == "ERR")
+        {
+            report.errors++;
+            if (session.state == State::Playing)
+            {
+                sent = sendClose(index);
+            }
+            else
+            {
+                session.state = State::Done;
+                openSessions--;
+            }
+        }
+        else if (session.state == State::Opening)
+        {
+            stream >> session.id;
+            session.gameMaster = GameMaster();
+            sent = timeIsUp ? sendClose(index) : sendPlay(index, true);
+        }
+        else if (session.state == State::Playing && result == "BUSY")
+        {
+            // All workers are busy, so we try the same move again a little later.
+            report.busyResponses++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            sent = timeIsUp ? sendClose(index) : sendPlay(index, false);
+        }
+        else if (session.state == State::Playing)
+        {
+            latencies.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - session.sentAt).count());
+            report.moves++;
+
+            int algorithmColumn = 0;
+            std::string status;
+            stream >> algorithmColumn >> status;
+            session.gameMaster.playMove(session.pendingColumn, Field::Player::Human);
+            if (algorithmColumn > 0)
+                session.gameMaster.playMove(algorithmColumn, Field::Player::Algorithm);
+
+            if (status != "RUNNING")
+            {
+                report.games++;
+                sent = sendClose(index);
+            }
+            else
+            {
+                sent = timeIsUp ? sendClose(index) : sendPlay(index, true);
+            }
+        }
+        else if (session.state == State::Closing)
+        {
+            if (timeIsUp)
+            {
+                session.state = State::Done;
+                openSessions--;
+            }
+            else
+            {
+                session.state = State::Opening;
+                sent = socket.writeLine(std::to_string(index) + " NEW");
+            }
+        }
+
+        if (!sent)
+            return false;
+    }
+
+    return openSessions == 0;
+}
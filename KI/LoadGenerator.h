@@ -0,0 +1,47 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Client for the GameServer that plays many games with random human moves at the same time and measures how long the
+// server takes to answer every move.
+class LoadGenerator
+{
+public:
+    struct Options
+    {
+        std::string     host                    = "127.0.0.1";
+        uint16_t        port                    = 4444;
+        int             connections             = 4;
+        int             sessionsPerConnection   = 64;
+        int             timeBudgetMs            = 50;
+        int             durationSeconds         = 10;
+        uint32_t        seed                    = 1;
+    };
+
+    struct Report
+    {
+        size_t          moves                   = 0;
+        size_t          games                   = 0;
+        size_t          busyResponses           = 0;
+        size_t          errors                  = 0;
+        double          seconds                 = 0;
+        double          p50Ms                   = 0;
+        double          p99Ms                   = 0;
+        double          maxMs                   = 0;
+    };
+
+    LoadGenerator(const Options& options);
+
+    bool run(Report& report);
+    static void printReport(const Report& report);
+
+private:
+    bool runConnection(uint32_t seed, std::vector<double>& latencies, Report& report);
+
+    Options m_options;
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "MonteCarlo.h"
+
+// Weight of the exploration term of UCT.
+constexpr double EXPLORATION = 1.41;
+
+// A leaf gets children once it has been visited this often. Expanding every leaf right away wastes the pool on nodes
+// that are visited only once.
+constexpr uint32_t EXPANSION_THRESHOLD = 2;
+
+/**
+ * Helper function for a fast random number generator (xorshift64).
+ *
+ * \param state The state of the generator. Must not be 0.
+ * \return Returns the next random number.
+ */
+static uint64_t nextRandom(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/**
+ * Public constructor. The node pool is allocated by MonteCarlo::setMemoryBudget, or by the first search for the default
+ * memory budget, so a pool that is replaced right away is never allocated.
+ *
+ * \param threadCount The number of threads searching the tree. 0 uses one thread per core.
+ */
+MonteCarlo::MonteCarlo(int threadCount) : m_threadCount(threadCount)
+{
+    if (m_threadCount <= 0)
+        m_threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+/**
+ * Getter for the name of the engine.
+ *
+ * \return Returns the name used by Engine::create.
+ */
+std::string MonteCarlo::name()
+{
+    return "mcts";
+}
+
+/**
+ * Calculates the next move the algorithm wants to make.
+ *
+ * \param field The field the algorithm has to make its move on.
+ * \param timeBudgetMs The time the search may take in milliseconds. 0 uses MONTE_CARLO_DEFAULT_TIME_MS.
+ * \return The number of the column in which the algorithm wants make its next move starting at 1. -1 if the game is
+ * over.
+ */
+int MonteCarlo::getNextMove(Field field, int timeBudgetMs)
+{
+    if (field.isGameOver())
+        return -1;
+
+    if (!m_pool)
+        setMemoryBudget(ENGINE_DEFAULT_MEMORY_BUDGET_MB);
+
+    // Reset the nodes the last search used and create the root.
+    size_t usedNodes = std::min(m_usedNodes.load(), m_poolSize);
+    for (size_t index = 0; index < usedNodes; index++)
+    {
+        TreeNode& node = m_pool[index];
+        node.visits.store(0, std::memory_order_relaxed);
+        node.reward.store(0, std::memory_order_relaxed);
+        node.firstChild.store(0, std::memory_order_relaxed);
+        node.state.store(NodeState::Leaf, std::memory_order_relaxed);
+        node.childCount = 0;
+        node.move = 0;
+        node.result = NodeResult::None;
+    }
+    m_usedNodes = 1;
+    m_playouts = 0;
+
+    Bitboard root(field, Field::Player::Algorithm);
+    expand(0, root);
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+        + std::chrono::milliseconds(timeBudgetMs > 0 ? timeBudgetMs : MONTE_CARLO_DEFAULT_TIME_MS);
+
+    std::vector<std::thread> helpers;
+    for (int threadNr = 1; threadNr < m_threadCount; threadNr++)
+    {
+        helpers.emplace_back(&MonteCarlo::work, this, std::cref(root), deadline, 0x9E3779B97F4A7C15ULL * threadNr);
+    }
+    work(root, deadline, 0x2545F4914F6CDD1DULL);
+    for (std::thread& helper : helpers)
+    {
+        helper.join();
+    }
+
+    // The most visited move is the most reliable one.
+    TreeNode& rootNode = m_pool[0];
+    int moveToMake = -1;
+    uint32_t mostVisits = 0;
+    for (uint32_t child = 0; child < rootNode.childCount; child++)
+    {
+        TreeNode& childNode = m_pool[rootNode.firstChild + child];
+        if (childNode.visits > mostVisits || moveToMake == -1)
+        {
+            mostVisits = childNode.visits;
+            moveToMake = childNode.move + 1;
+        }
+    }
+
+    return moveToMake;
+}
+
+/**
+ * Allocates the node pool for a memory budget. The whole pool is allocated up front. Once a search has used it up,
+ * the tree stops growing and the remaining time is spent on more playouts from the existing leaves.
+ *
+ * \param megabytes The memory budget in MB.
+ */
+void MonteCarlo::setMemoryBudget(size_t megabytes)
+{
+    // Nodes are addressed with 32 bit indices.
+    size_t poolSize = std::min<size_t>(megabytes * 1024 * 1024 / sizeof(TreeNode), UINT32_MAX);
+    poolSize = std::max<size_t>(poolSize, FIELD_WIDTH + 1);
+    if (m_pool && poolSize == m_poolSize)
+        return;
+
+    // Release the old pool first, so the old and the new one are never allocated at the same time.
+    m_pool.reset();
+    m_poolSize = poolSize;
+    m_pool.reset(new TreeNode[m_poolSize]);
+    m_usedNodes = 0;
+}
+
+/**
+ * Gives info about the number of playouts of the last search.
+ *
+ * \return Returns the number of playouts.
+ */
+uint64_t MonteCarlo::getPlayouts()
+{
+    return m_playouts;
+}
+
+/**
+ * Loop of every search thread.
+ *
+ * \param root The field of the root node.
+ * \param deadline The time the search ends.
+ * \param seed Seed of the random playouts of the thread.
+ */
+void MonteCarlo::work(const Bitboard& root, std::chrono::steady_clock::time_point deadline, uint64_t seed)
+{
+    uint64_t random = seed;
+    uint64_t playouts = 0;
+    do
+    {
+        // Reading the clock is more expensive than a playout, so it is only checked every few iterations.
+        for (int iteration = 0; iteration < 64; iteration++)
+        {
+            iterate(root, random);
+        }
+        playouts += 64;
+    } while (std::chrono::steady_clock::now() < deadline);
+
+    m_playouts += playouts;
+}
+
+/**
+ * Runs a single iteration: selects a leaf, expands it, plays a random game from there and propagates the result back
+ * to the root.
+ *
+ * \param root The field of the root node.
+ * \param random The state of the random number generator of the thread.
+ */
+void MonteCarlo::iterate(const Bitboard& root, uint64_t& random)
+{
+    uint32_t path[FIELD_WIDTH * FIELD_HEIGHT + 1];
+    int pathLength = 0;
+    Bitboard board = root;
+    uint32_t current = 0;
+
+    path[pathLength++] = current;
+    m_pool[current].visits.fetch_add(1, std::memory_order_relaxed);
+
+    // Result seen from the player to move at the end of the path: 1 is a win, 0 a draw and -1 a loss.
+    int outcome;
+    while (true)
+    {
+        TreeNode& node = m_pool[current];
+        if (node.result == NodeResult::Win)
+        {
+            outcome = -1;
+            break;
+        }
+        else if (node.result == NodeResult::Draw)
+        {
+            outcome = 0;
+            break;
+        }
+
+        if (node.state.load(std::memory_order_acquire) != NodeState::Expanded)
+        {
+            if (node.visits.load(std::memory_order_relaxed) >= EXPANSION_THRESHOLD)
+                expand(current, board);
+
+            if (node.state.load(std::memory_order_acquire) != NodeState::Expanded)
+            {
+                outcome = playout(board, random);
+                break;
+            }
+        }
+
+        current = selectChild(current);
+        m_pool[current].visits.fetch_add(1, std::memory_order_relaxed);
+        board.play(m_pool[current].move);
+        path[pathLength++] = current;
+    }
+
+    // Every node is rewarded from the view of the player that made the move leading to it. That player is the one to
+    // move at the end of the path for every second node, counting back from the end.
+    for (int index = pathLength - 1; index > 0; index--)
+    {
+        bool sameAsLast = (pathLength - 1 - index) % 2 == 1;
+        int result = sameAsLast ? outcome : -outcome;
+        if (result >= 0)
+            m_pool[path[index]].reward.fetch_add(result + 1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Creates the children of a leaf. If another thread already expands the leaf, nothing happens.
+ *
+ * \param index The index of the leaf in the pool.
+ * \param board The field of the leaf.
+ */
+void MonteCarlo::expand(uint32_t index, const Bitboard& board)
+{
+    TreeNode& node = m_pool[index];
+    NodeState expected = NodeState::Leaf;
+    if (!node.state.compare_exchange_strong(expected, NodeState::Expanding, std::memory_order_acq_rel))
+        return;
+
+    uint8_t childCount = 0;
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        if (board.canPlay(column))
+            childCount++;
+    }
+
+    size_t firstChild = m_usedNodes.fetch_add(childCount);
+    if (firstChild + childCount > m_poolSize)
+    {
+        // The pool is used up. The node stays a leaf, but is marked so no thread tries again.
+        node.state.store(NodeState::Expanding, std::memory_order_release);
+        return;
+    }
+
+    uint32_t child = (uint32_t)firstChild;
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        if (!board.canPlay(column))
+            continue;
+
+        TreeNode& childNode = m_pool[child++];
+        childNode.move = (uint8_t)column;
+        if (board.isWinningMove(column))
+            childNode.result = NodeResult::Win;
+        else if (board.moveCount() + 1 == FIELD_WIDTH * FIELD_HEIGHT)
+            childNode.result = NodeResult::Draw;
+    }
+
+    node.firstChild.store((uint32_t)firstChild, std::memory_order_relaxed);
+    node.childCount = childCount;
+    node.state.store(NodeState::Expanded, std::memory_order_release);
+}
+
+/**
+ * Picks the child with the best UCT value.
+ *
+ * \param index The index of an expanded node in the pool.
+ * \return Returns the index of the child in the pool.
+ */
+uint32_t MonteCarlo::selectChild(uint32_t index)
+{
+    TreeNode& node = m_pool[index];
+    double logVisits = std::log((double)std::max(1u, node.visits.load(std::memory_order_relaxed)));
+    uint32_t firstChild = node.firstChild.load(std::memory_order_relaxed);
+
+    uint32_t bestChild = firstChild;
+    double bestValue = -1;
+    for (uint32_t child = firstChild; child < firstChild + node.childCount; child++)
+    {
+        TreeNode& childNode = m_pool[child];
+        uint32_t visits = childNode.visits.load(std::memory_order_relaxed);
+        if (visits == 0)
+            return child;
+
+        double winRate = childNode.reward.load(std::memory_order_relaxed) / (2.0 * visits);
+        double value = winRate + EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue)
+        {
+            bestValue = value;
+            bestChild = child;
+        }
+    }
+
+    return bestChild;
+}
+
+/**
+ * Plays random moves until the game is over. A move that wins right away is always taken.
+ *
+ * \param board The field to start from.
+ * \param random The state of the random number generator of the thread.
+ * \return Returns 1 if the player to move on the given field wins, 0 for a draw and -1 for a loss.
+ */
+int MonteCarlo::playout(Bitboard board, uint64_t& random)
+{
+    int sign = 1;
+    while (!board.isFull())
+    {
+        if (board.winningPositions() & board.possibleMoves())
+            return sign;
+
+        int columns[FIELD_WIDTH];
+        int columnCount = 0;
+        for (int column = 0; column < FIELD_WIDTH; column++)
+        {
+            if (board.canPlay(column))
+                columns[columnCount++] = column;
+        }
+
+        board.play(columns[nextRandom(random) % columnCount]);
+        sign = -sign;
+    }
+
+    return 0;
+}
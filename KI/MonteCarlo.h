@@ -0,0 +1,66 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "Bitboard.h"
+#include "Engine.h"
+
+// Time a search takes if getNextMove is called without a time budget.
+constexpr int MONTE_CARLO_DEFAULT_TIME_MS = 1000;
+
+// Monte Carlo tree search with UCT selection and random playouts on a Bitboard. All threads work on the same tree
+// (tree parallelism). A thread that walks through a node counts its visit right away, but adds the result only after
+// its playout. Until then the visit counts like a lost game (virtual loss), so other threads prefer other branches.
+class MonteCarlo : public Engine
+{
+public:
+    MonteCarlo(int threadCount = 0);
+
+    std::string name() override;
+    int getNextMove(Field field, int timeBudgetMs = 0) override;
+    void setMemoryBudget(size_t megabytes) override;
+    uint64_t getPlayouts();
+
+private:
+    enum class NodeState : uint8_t
+    {
+        Leaf,
+        Expanding,
+        Expanded
+    };
+
+    enum class NodeResult : uint8_t
+    {
+        None,
+        Win,        // The move that led to this node won the game
+        Draw        // The move that led to this node filled the field
+    };
+
+    struct TreeNode
+    {
+        std::atomic<uint32_t>   visits{ 0 };
+        std::atomic<uint32_t>   reward{ 0 };        // 2 per won and 1 per drawn playout of the player that moved
+        std::atomic<uint32_t>   firstChild{ 0 };
+        std::atomic<NodeState>  state{ NodeState::Leaf };
+        uint8_t                 childCount  = 0;
+        uint8_t                 move        = 0;    // Column starting at 0
+        NodeResult              result      = NodeResult::None;
+    };
+
+    void work(const Bitboard& root, std::chrono::steady_clock::time_point deadline, uint64_t seed);
+    void iterate(const Bitboard& root, uint64_t& random);
+    void expand(uint32_t index, const Bitboard& board);
+    uint32_t selectChild(uint32_t index);
+    static int playout(Bitboard board, uint64_t& random);
+
+    std::unique_ptr<TreeNode[]>     m_pool;
+    size_t                          m_poolSize          = 0;
+    std::atomic<size_t>             m_usedNodes{ 0 };
+    std::atomic<uint64_t>           m_playouts{ 0 };
+    int                             m_threadCount;
+};
+
+#endif
@@ -1,8 +1,11 @@
 #include <cmath>
 #include <string>
 #include <algorithm>
+#include <climits>
 
 #include "Node.h"
+#include "PerfCounters.h"
+#include "Trace.h"
 
 /**
  * Public constructor.
@@ -12,6 +15,27 @@ Node::Node()
 {
 }
 
+/**
+ * Destructor. The default destructor would free the tree recursively, one stack frame per level. Instead every node
+ * that is only owned by this tree hands its children to a list before it is destroyed, so the tree is freed in a loop.
+ *
+ */
+Node::~Node()
+{
+    std::vector<std::shared_ptr<Node>> pending = std::move(m_children);
+    while (!pending.empty())
+    {
+        std::shared_ptr<Node> node = std::move(pending.back());
+        pending.pop_back();
+        if (node.use_count() == 1)
+        {
+            for (std::shared_ptr<Node>& child : node->m_children)
+                pending.push_back(std::move(child));
+            node->m_children.clear();
+        }
+    }
+}
+
 /**
  * Initializes the node. This method has to be called after the node was created!
  *
@@ -33,9 +57,14 @@ void Node::init(Field field, Field::Player turn, int moveToMake)
 /**
  * Evaluates the state of the node. This value is accessible using Node::getNodeValue
  * 
+ * \param cache The cache of evaluations of other nodes. Can be nullptr.
+ * \param statistics Counts the lookups in the cache. Can be nullptr.
  */
-void Node::evaluateState()
+void Node::evaluateState(EvaluationCache* cache, EvaluationCache::Statistics* statistics)
 {
+    TRACE_SCOPE("evaluateState");
+    PERF_SCOPE(PerfCounters::Region::EvaluateState);
+
     if (m_field.isDraw())
     {
         m_nodeValue = 0;
@@ -51,6 +80,18 @@ void Node::evaluateState()
         return;
     }
 
+    // The evaluation only depends on the stones, so it can be shared by every node with the same field.
+    uint64_t key = 0;
+    if (cache)
+    {
+        key = m_field.getKey();
+        bool found = cache->probe(key, m_nodeValue);
+        if (statistics)
+            (found ? statistics->hits : statistics->misses)++;
+        if (found)
+            return;
+    }
+
     int score = 0;
 
     // Score center column separate, because it is the most valuable column
@@ -119,6 +160,8 @@ void Node::evaluateState()
     }
 
     m_nodeValue = score;
+    if (cache)
+        cache->store(key, score);
 }
 
 /**
@@ -189,6 +232,26 @@ int Node::getMoveMade()
     return m_moveMade;
 }
 
+/**
+ * Setter for the move of the child that gave the node its value.
+ *
+ * \param move The column of the move. -1 if it is not known.
+ */
+void Node::setBestMove(int move)
+{
+    m_bestMove = move;
+}
+
+/**
+ * Getter for the move of the child that gave the node its value.
+ *
+ * \return Returns the column of the move. -1 if it is not known.
+ */
+int Node::getBestMove()
+{
+    return m_bestMove;
+}
+
 /**
  * Getter for the value of the node.
  * 
@@ -211,6 +274,9 @@ void Node::createNextMoves(int depth)
     if (depth == 0 || m_field.isGameOver())
         return;
 
+    TRACE_SCOPE("createNextMoves");
+    PERF_SCOPE(PerfCounters::Region::CreateNextMoves);
+
     // If this node already has children, just pass the instruction along.
     // Otherwise create children.
     if (m_children.empty())
@@ -244,12 +310,33 @@ bool Node::isGameOver()
     return m_field.isGameOver();
 }
 
+/**
+ * Getter for the packed key of the field the node represents.
+ *
+ * \return Returns the key. See Field::getKey.
+ */
+uint64_t Node::getKey()
+{
+    return m_field.getKey();
+}
+
+/**
+ * Frees all children of the node and everything below them. The node can be expanded again with
+ * Node::createNextMoves.
+ *
+ */
+void Node::releaseChildren()
+{
+    m_children.clear();
+    m_children.shrink_to_fit();
+}
+
 /**
  * Getter for the children of the node.
  * 
  * \return 
  */
-std::vector<std::shared_ptr<Node>> Node::getChildren()
+const std::vector<std::shared_ptr<Node>>& Node::getChildren()
 {
     return m_children;
 }
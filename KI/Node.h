@@ -3,21 +3,27 @@
 
 #include <vector>
 #include <memory>
+#include "EvaluationCache.h"
 #include "Field.h"
 
 class Node
 {
 public:
     Node();
+    ~Node();
 
     void init(Field field, Field::Player turn, int moveToMake = -1);
-    void evaluateState();
+    void evaluateState(EvaluationCache* cache = nullptr, EvaluationCache::Statistics* statistics = nullptr);
     void setNodeValue(int value);
     int getNodeValue();
     int getMoveMade();
+    void setBestMove(int move);
+    int getBestMove();
     void createNextMoves(int depth);
     bool isGameOver();
-    std::vector<std::shared_ptr<Node>> getChildren();
+    uint64_t getKey();
+    const std::vector<std::shared_ptr<Node>>& getChildren();
+    void releaseChildren();
 
 private:
     int evaluateSubset(std::vector<char>::iterator begin, std::vector<char>::iterator end);
@@ -25,6 +31,7 @@ private:
     std::vector<std::shared_ptr<Node>>  m_children;
     Field                               m_field;
     int                                 m_moveMade  = -1;
+    int                                 m_bestMove  = -1;
     int                                 m_nodeValue = 0;
     Field::Player                       m_turn      = Field::Player::Algorithm;
 };
@@ -0,0 +1,291 @@
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "PerfCounters.h"
+
+namespace
+{
+    struct CounterDefinition
+    {
+        const char*     name;
+        uint32_t        type;
+        uint64_t        config;
+    };
+
+#if defined(__linux__)
+    // Cache events are configured as cache | operation << 8 | result << 16.
+    const CounterDefinition COUNTERS[PerfCounters::COUNTER_COUNT] = {
+        { "cycles",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { "instructions",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { "L1d misses",     PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { "LLC misses",     PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { "branch misses",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+#else
+    const CounterDefinition COUNTERS[PerfCounters::COUNTER_COUNT] = {
+        { "cycles", 0, 0 }, { "instructions", 0, 0 }, { "L1d misses", 0, 0 }, { "LLC misses", 0, 0 },
+        { "branch misses", 0, 0 },
+    };
+#endif
+
+    const char* REGION_NAMES[PerfCounters::REGION_COUNT] = { "minimax", "createNextMoves", "evaluateState",
+        "proofNumberSearch" };
+
+    // Counters of one thread. perf_event_open counts the thread that opened the events, so every thread needs its own.
+    struct ThreadState
+    {
+        bool                        opened                                      = false;
+        int                         leader                                      = -1;
+        int                         fileDescriptors[PerfCounters::COUNTER_COUNT];
+        int                         groupIndex[PerfCounters::COUNTER_COUNT];    // -1 if the counter is missing
+        int                         groupSize                                   = 0;
+        std::string                 unavailableReason;
+        uint64_t                    lastValues[PerfCounters::COUNTER_COUNT]     = {};
+        int64_t                     lastNanoseconds                             = 0;
+        std::vector<int>            regions;
+        PerfCounters::Sample        totals;
+
+        ~ThreadState()
+        {
+#if defined(__linux__)
+            for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+            {
+                if (opened && groupIndex[counterNr] != -1)
+                    close(fileDescriptors[counterNr]);
+            }
+#endif
+        }
+    };
+
+    thread_local ThreadState t_state;
+}
+
+/**
+ * Helper function to open the counters of the calling thread as one group, so they are read at once. Counters the
+ * system does not support are left out.
+ *
+ * \param state The state of the calling thread.
+ */
+static void openCounters(ThreadState& state)
+{
+    state.opened = true;
+    for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+        state.groupIndex[counterNr] = -1;
+
+#if defined(__linux__)
+    for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+    {
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = COUNTERS[counterNr].type;
+        attributes.config = COUNTERS[counterNr].config;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+
+        int fileDescriptor = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, state.leader, 0);
+        if (fileDescriptor == -1)
+        {
+            if (state.unavailableReason.empty())
+                state.unavailableReason = std::string(COUNTERS[counterNr].name) + ": " + strerror(errno);
+            continue;
+        }
+
+        if (state.leader == -1)
+            state.leader = fileDescriptor;
+        state.fileDescriptors[counterNr] = fileDescriptor;
+        state.groupIndex[counterNr] = state.groupSize++;
+    }
+
+    if (state.leader != -1)
+    {
+        ioctl(state.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(state.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    state.unavailableReason = "perf_event_open is only available on Linux";
+#endif
+}
+
+/**
+ * Helper function to read the current values of all counters of the calling thread.
+ *
+ * \param state The state of the calling thread.
+ * \param values Receives the values. Missing counters are 0.
+ * \param nanoseconds Receives the current time.
+ */
+static void readCounters(ThreadState& state, uint64_t values[PerfCounters::COUNTER_COUNT], int64_t& nanoseconds)
+{
+    if (!state.opened)
+        openCounters(state);
+
+    nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+        values[counterNr] = 0;
+
+#if defined(__linux__)
+    if (state.leader == -1)
+        return;
+
+    // Layout of a group read: number of counters, time enabled, time running, one value per counter.
+    uint64_t buffer[3 + PerfCounters::COUNTER_COUNT];
+    if (::read(state.leader, buffer, sizeof(buffer)) < (ssize_t)(sizeof(uint64_t) * (3 + state.groupSize)))
+        return;
+
+    if (buffer[2] < buffer[1])
+        state.totals.multiplexed = true;
+
+    for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+    {
+        if (state.groupIndex[counterNr] != -1)
+            values[counterNr] = buffer[3 + state.groupIndex[counterNr]];
+    }
+#endif
+}
+
+/**
+ * Helper function to charge everything since the last read to the innermost region of the calling thread.
+ *
+ * \param state The state of the calling thread.
+ */
+static void chargeRegion(ThreadState& state)
+{
+    uint64_t values[PerfCounters::COUNTER_COUNT];
+    int64_t nanoseconds;
+    readCounters(state, values, nanoseconds);
+
+    if (!state.regions.empty())
+    {
+        int region = state.regions.back();
+        state.totals.nanoseconds[region] += nanoseconds - state.lastNanoseconds;
+        for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+            state.totals.values[region][counterNr] += values[counterNr] - state.lastValues[counterNr];
+    }
+
+    memcpy(state.lastValues, values, sizeof(values));
+    state.lastNanoseconds = nanoseconds;
+}
+
+/**
+ * Starts a region on the calling thread. The region that was running before is paused until PerfCounters::leave.
+ *
+ * \param region The region.
+ */
+void PerfCounters::enter(Region region)
+{
+    chargeRegion(t_state);
+    t_state.regions.push_back((int)region);
+    t_state.totals.calls[(int)region]++;
+}
+
+/**
+ * Ends the innermost region of the calling thread.
+ *
+ */
+void PerfCounters::leave()
+{
+    chargeRegion(t_state);
+    if (!t_state.regions.empty())
+        t_state.regions.pop_back();
+}
+
+/**
+ * Indicates if a counter could be opened for the calling thread.
+ *
+ * \param counter The counter.
+ * \return Returns true if the counter is counted.
+ */
+bool PerfCounters::isAvailable(Counter counter)
+{
+    if (!t_state.opened)
+        openCounters(t_state);
+
+    return t_state.groupIndex[(int)counter] != -1;
+}
+
+/**
+ * Gives info about why counters are missing.
+ *
+ * \return Returns the error of the first counter that could not be opened. Empty if all counters are available.
+ */
+std::string PerfCounters::unavailableReason()
+{
+    if (!t_state.opened)
+        openCounters(t_state);
+
+    return t_state.unavailableReason;
+}
+
+/**
+ * Gives the totals of the calling thread.
+ *
+ * \return Returns the totals since the last PerfCounters::reset.
+ */
+PerfCounters::Sample PerfCounters::read()
+{
+    return t_state.totals;
+}
+
+/**
+ * Sets the totals of the calling thread to 0. Must not be called inside of a region.
+ *
+ */
+void PerfCounters::reset()
+{
+    t_state.totals = Sample();
+    t_state.regions.clear();
+}
+
+/**
+ * Getter for the name of a region.
+ *
+ * \param region The region.
+ * \return Returns the name.
+ */
+const char* PerfCounters::name(Region region)
+{
+    return REGION_NAMES[(int)region];
+}
+
+/**
+ * Getter for the name of a counter.
+ *
+ * \param counter The counter.
+ * \return Returns the name.
+ */
+const char* PerfCounters::name(Counter counter)
+{
+    return COUNTERS[(int)counter].name;
+}
+
+/**
+ * Public constructor. Enters the region.
+ *
+ * \param region The region.
+ */
+PerfScope::PerfScope(PerfCounters::Region region)
+{
+    PerfCounters::enter(region);
+}
+
+/**
+ * Destructor. Leaves the region.
+ *
+ */
+PerfScope::~PerfScope()
+{
+    PerfCounters::leave();
+}
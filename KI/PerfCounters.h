@@ -0,0 +1,89 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include "CustomDefines.h"
+
+// Hardware performance counters of the search, read with perf_event_open on Linux. Scopes marked with PERF_SCOPE
+// charge the cycles, instructions, cache misses and branch misses of the calling thread to their region. Only the
+// time a region spends outside of nested regions is charged to it, so minimax does not include the evaluation of its
+// leaves and the regions, including the proof-number search before minimax, add up to the whole search.
+// If the counters can not be opened (other systems, missing permissions, virtual machines without a PMU), only the
+// calls and the time of the regions are counted.
+// Every scope reads the counters with a system call, which makes the search several times slower. Compare the ratios
+// of the regions and the values per node, not the absolute time.
+//
+// The counters are compiled out unless KI_PERF_COUNTERS is defined, so the scopes cost nothing in normal builds.
+#ifdef KI_PERF_COUNTERS
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+// Charges the rest of the enclosing block to a region.
+#define PERF_SCOPE(region) PerfScope PERF_CONCAT(perfScope, __LINE__)(region)
+#else
+#define PERF_SCOPE(region) do { UNUSED(region); } while (0)
+#endif
+
+class PerfCounters
+{
+public:
+    enum class Region
+    {
+        Minimax,
+        CreateNextMoves,
+        EvaluateState,
+        ProofNumberSearch
+    };
+
+    enum class Counter
+    {
+        Cycles,
+        Instructions,
+        L1DataMisses,
+        LastLevelMisses,
+        BranchMisses
+    };
+
+    static constexpr int REGION_COUNT = 4;
+    static constexpr int COUNTER_COUNT = 5;
+
+    // Totals of the calling thread since the last PerfCounters::reset.
+    struct Sample
+    {
+        uint64_t    calls[REGION_COUNT]                     = {};
+        uint64_t    nanoseconds[REGION_COUNT]               = {};
+        uint64_t    values[REGION_COUNT][COUNTER_COUNT]     = {};
+        bool        multiplexed                             = false;   // The counters did not run all the time
+    };
+
+    static constexpr bool isEnabled()
+    {
+#ifdef KI_PERF_COUNTERS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void enter(Region region);
+    static void leave();
+    static bool isAvailable(Counter counter);
+    static std::string unavailableReason();
+    static Sample read();
+    static void reset();
+    static const char* name(Region region);
+    static const char* name(Counter counter);
+};
+
+// Charges the time between its construction and destruction to a region, see PERF_SCOPE.
+class PerfScope
+{
+public:
+    PerfScope(PerfCounters::Region region);
+    ~PerfScope();
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+};
+
+#endif
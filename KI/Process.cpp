@@ -0,0 +1,144 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Process.h"
+
+/**
+ * Public constructor. Does not start a process yet.
+ *
+ */
+Process::Process()
+{
+}
+
+/**
+ * Destructor. Releases the handle of the process.
+ *
+ */
+Process::~Process()
+{
+#ifdef _WIN32
+    if (m_handle)
+        CloseHandle(m_handle);
+#endif
+}
+
+/**
+ * Starts the process. The object must not have a running process.
+ *
+ * \param executable The path of the program.
+ * \param arguments The arguments without the program itself.
+ * \return Returns true if the operation was successful.
+ */
+bool Process::start(const std::string& executable, const std::vector<std::string>& arguments)
+{
+#ifdef _WIN32
+    // Windows passes a single command line, so every argument is quoted.
+    std::string commandLine = "\"" + executable + "\"";
+    for (const std::string& argument : arguments)
+        commandLine += " \"" + argument + "\"";
+
+    STARTUPINFOA startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo = {};
+    if (!CreateProcessA(executable.c_str(), &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr,
+        &startupInfo, &processInfo))
+        return false;
+
+    CloseHandle(processInfo.hThread);
+    m_handle = processInfo.hProcess;
+    return true;
+#else
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(executable.c_str()));
+    for (const std::string& argument : arguments)
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0)
+        return false;
+
+    if (pid == 0)
+    {
+        execv(executable.c_str(), argv.data());
+        _exit(127);
+    }
+
+    m_pid = pid;
+    return true;
+#endif
+}
+
+/**
+ * Indicates if the process is still running.
+ *
+ * \return Returns true if the process was started and has not ended yet.
+ */
+bool Process::isRunning()
+{
+#ifdef _WIN32
+    return m_handle && WaitForSingleObject(m_handle, 0) == WAIT_TIMEOUT;
+#else
+    if (m_pid <= 0)
+        return false;
+
+    int status;
+    if (waitpid(m_pid, &status, WNOHANG) == 0)
+        return true;
+
+    m_pid = -1;
+    return false;
+#endif
+}
+
+/**
+ * Waits until the process has ended.
+ *
+ * \return Returns the exit code of the process. -1 if it was not started, did not exit normally or has already been
+ * reaped by Process::isRunning.
+ */
+int Process::wait()
+{
+#ifdef _WIN32
+    if (!m_handle)
+        return -1;
+
+    DWORD exitCode;
+    WaitForSingleObject(m_handle, INFINITE);
+    bool success = GetExitCodeProcess(m_handle, &exitCode);
+    CloseHandle(m_handle);
+    m_handle = nullptr;
+    return success ? (int)exitCode : -1;
+#else
+    if (m_pid <= 0)
+        return -1;
+
+    int status;
+    pid_t result = waitpid(m_pid, &status, 0);
+    m_pid = -1;
+    return result > 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+/**
+ * Ends the process right away.
+ *
+ */
+void Process::kill()
+{
+#ifdef _WIN32
+    if (m_handle)
+        TerminateProcess(m_handle, 1);
+#else
+    if (m_pid > 0)
+        ::kill(m_pid, SIGKILL);
+#endif
+    wait();
+}
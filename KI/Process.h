@@ -0,0 +1,31 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <string>
+#include <vector>
+
+// Child process, e.g. a worker of the Coordinator that runs this program with other arguments. The process keeps
+// running if the object is destroyed, unless Process::kill was called.
+class Process
+{
+public:
+    Process();
+    ~Process();
+
+    Process(const Process&) = delete;
+    Process& operator=(const Process&) = delete;
+
+    bool start(const std::string& executable, const std::vector<std::string>& arguments);
+    bool isRunning();
+    int wait();
+    void kill();
+
+private:
+#ifdef _WIN32
+    void*   m_handle    = nullptr;
+#else
+    int     m_pid       = -1;
+#endif
+};
+
+#endif
@@ -0,0 +1,406 @@
+#include <algorithm>
+
+#include "ProofNumberSearch.h"
+
+// Proof or disproof number of a question that can not be answered anymore. Half the range, so a threshold can always
+// be raised by one without overflowing.
+constexpr uint32_t PROOF_NUMBER_INFINITY = UINT32_MAX / 2;
+
+// Bit that is added to a key if the attacker, i.e. the player that tries to win, is the player to move.
+constexpr uint64_t PROOF_NUMBER_KEY_ATTACKER = uint64_t(1) << 63;
+
+// Nodes between two calls of the stop callback. A node takes about a microsecond.
+constexpr uint64_t PROOF_NUMBER_STOP_INTERVAL = 64;
+
+/**
+ * Helper function to spread the packed keys over the whole table.
+ *
+ * \param key The key to hash.
+ * \return Returns the hashed key.
+ */
+static uint64_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * Helper function to add proof or disproof numbers without going past PROOF_NUMBER_INFINITY.
+ *
+ * \param first The first number.
+ * \param second The second number.
+ * \return Returns the sum.
+ */
+static uint32_t addNumbers(uint32_t first, uint32_t second)
+{
+    return (uint32_t)std::min<uint64_t>((uint64_t)first + second, PROOF_NUMBER_INFINITY);
+}
+
+/**
+ * Public constructor.
+ *
+ * \param tableSize The number of entries of the table. It is rounded down to a power of two.
+ */
+ProofNumberSearch::ProofNumberSearch(size_t tableSize)
+{
+    size_t roundedSize = 1;
+    while (roundedSize * 2 <= tableSize)
+        roundedSize *= 2;
+
+    m_table.reset(new Entry[roundedSize]);
+    m_tableMask = roundedSize - 1;
+}
+
+/**
+ * Answers whether the player to move can force a win or will lose. The win is searched first with half the budget,
+ * the loss with the rest.
+ *
+ * \param board The position. The game must not be over.
+ * \param maxNodes The maximum number of nodes to search.
+ * \param line Receives the moves of a winning line from the position on, for a win or a loss. Columns start at 0.
+ * \param stop Stops the search early, e.g. at a deadline. Can be nullptr.
+ * \return Returns the answer. Draw means, that both questions were answered with no.
+ */
+ProofNumberSearch::Result ProofNumberSearch::prove(const Bitboard& board, uint64_t maxNodes,
+    std::vector<int>& line, const StopCallback& stop)
+{
+    uint64_t startNodes = m_nodeCount;
+    Result win = proveWin(board, maxNodes / 2, line, stop);
+    if (win == Result::Win)
+        return Result::Win;
+
+    // The loss is a win of the opponent, who is not the player to move at the root.
+    uint64_t remainingNodes = maxNodes - std::min(maxNodes, m_nodeCount - startNodes);
+    uint32_t proof;
+    uint32_t disproof;
+    m_maxNodes = m_nodeCount + remainingNodes;
+    m_stop = stop ? &stop : nullptr;
+    m_nextStopCheck = m_nodeCount;
+    mid(board, false, PROOF_NUMBER_INFINITY, PROOF_NUMBER_INFINITY, proof, disproof);
+    m_stop = nullptr;
+    if (proof == 0)
+    {
+        line.clear();
+        getLine(board, false, line);
+        return Result::Loss;
+    }
+
+    return disproof == 0 && win == Result::NoWin ? Result::Draw : Result::Unknown;
+}
+
+/**
+ * Answers only whether the player to move can force a win. This is cheaper than ProofNumberSearch::prove, if a loss
+ * does not matter.
+ *
+ * \param board The position. The game must not be over.
+ * \param maxNodes The maximum number of nodes to search.
+ * \param line Receives the moves of a winning line from the position on. Columns start at 0.
+ * \param stop Stops the search early, e.g. at a deadline. Can be nullptr.
+ * \return Returns Win, NoWin or Unknown.
+ */
+ProofNumberSearch::Result ProofNumberSearch::proveWin(const Bitboard& board, uint64_t maxNodes,
+    std::vector<int>& line, const StopCallback& stop)
+{
+    uint32_t proof;
+    uint32_t disproof;
+    m_maxNodes = m_nodeCount + maxNodes;
+    m_stop = stop ? &stop : nullptr;
+    m_nextStopCheck = m_nodeCount;
+    mid(board, true, PROOF_NUMBER_INFINITY, PROOF_NUMBER_INFINITY, proof, disproof);
+    m_stop = nullptr;
+
+    line.clear();
+    if (proof == 0)
+    {
+        getLine(board, true, line);
+        return Result::Win;
+    }
+
+    return disproof == 0 ? Result::NoWin : Result::Unknown;
+}
+
+/**
+ * Gives info about the work of the search.
+ *
+ * \return Returns the number of nodes searched since the last call of ProofNumberSearch::clear.
+ */
+uint64_t ProofNumberSearch::getNodeCount()
+{
+    return m_nodeCount;
+}
+
+/**
+ * Helper method to check the node budget and the stop callback. The callback is only polled every
+ * PROOF_NUMBER_STOP_INTERVAL nodes. Once it returned true, the budget stays used up.
+ *
+ * \return Returns true if the search has to end.
+ */
+bool ProofNumberSearch::isOutOfBudget()
+{
+    if (m_nodeCount >= m_maxNodes)
+        return true;
+
+    if (m_stop && m_nodeCount >= m_nextStopCheck)
+    {
+        m_nextStopCheck = m_nodeCount + PROOF_NUMBER_STOP_INTERVAL;
+        if ((*m_stop)())
+        {
+            m_maxNodes = m_nodeCount;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Removes all entries of the table and resets the node count.
+ *
+ */
+void ProofNumberSearch::clear()
+{
+    std::fill(m_table.get(), m_table.get() + m_tableMask + 1, Entry());
+    m_nodeCount = 0;
+}
+
+/**
+ * Calculates how many entries fit into a memory budget.
+ *
+ * \param bytes The memory budget in bytes.
+ * \return Returns the number of entries to pass to the constructor, at least 1.
+ */
+size_t ProofNumberSearch::entriesForBudget(size_t bytes)
+{
+    return std::max<size_t>(bytes / PROOF_NUMBER_ENTRY_BYTES, 1);
+}
+
+/**
+ * Searches a node until its proof number reaches the proof threshold or its disproof number reaches the disproof
+ * threshold (multiple iterative deepening). The node budget stops the search early.
+ * The numbers are always those of the question "does the attacker win", the node is an OR node if the attacker is to
+ * move and an AND node otherwise.
+ *
+ * \param board The position.
+ * \param attacker Indicates if the attacker is the player to move.
+ * \param proofThreshold The proof threshold.
+ * \param disproofThreshold The disproof threshold.
+ * \param proof Receives the proof number of the node.
+ * \param disproof Receives the disproof number of the node.
+ */
+void ProofNumberSearch::mid(const Bitboard& board, bool attacker, uint32_t proofThreshold, uint32_t disproofThreshold,
+    uint32_t& proof, uint32_t& disproof)
+{
+    m_nodeCount++;
+
+    uint64_t moves;
+    if (evaluateTerminal(board, attacker, moves, proof, disproof))
+    {
+        store(board, attacker, proof, disproof);
+        return;
+    }
+
+    Bitboard children[FIELD_WIDTH];
+    uint32_t childProofs[FIELD_WIDTH];
+    uint32_t childDisproofs[FIELD_WIDTH];
+    int childCount = 0;
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        if (moves & Bitboard::columnMask(column))
+        {
+            children[childCount] = board;
+            children[childCount].play(column);
+            childCount++;
+        }
+    }
+
+    while (true)
+    {
+        // The attacker needs one proven move, the defender has to be refuted in every move.
+        proof = attacker ? PROOF_NUMBER_INFINITY : 0;
+        disproof = attacker ? 0 : PROOF_NUMBER_INFINITY;
+        int best = 0;
+        uint32_t secondBest = PROOF_NUMBER_INFINITY;
+        for (int childNr = 0; childNr < childCount; childNr++)
+        {
+            lookup(children[childNr], !attacker, childProofs[childNr], childDisproofs[childNr]);
+            uint32_t selection = attacker ? childProofs[childNr] : childDisproofs[childNr];
+            uint32_t bestSelection = attacker ? childProofs[best] : childDisproofs[best];
+            if (childNr == 0 || selection < bestSelection)
+            {
+                if (childNr > 0)
+                    secondBest = bestSelection;
+                best = childNr;
+            }
+            else
+            {
+                secondBest = std::min(secondBest, selection);
+            }
+
+            if (attacker)
+            {
+                proof = std::min(proof, childProofs[childNr]);
+                disproof = addNumbers(disproof, childDisproofs[childNr]);
+            }
+            else
+            {
+                proof = addNumbers(proof, childProofs[childNr]);
+                disproof = std::min(disproof, childDisproofs[childNr]);
+            }
+        }
+
+        if (proof >= proofThreshold || disproof >= disproofThreshold || isOutOfBudget())
+            break;
+
+        // Search the most promising child until it is no longer the most promising one.
+        uint32_t childProofThreshold;
+        uint32_t childDisproofThreshold;
+        if (attacker)
+        {
+            childProofThreshold = std::min(proofThreshold, secondBest + 1);
+            childDisproofThreshold = addNumbers(disproofThreshold - disproof, childDisproofs[best]);
+        }
+        else
+        {
+            childProofThreshold = addNumbers(proofThreshold - proof, childProofs[best]);
+            childDisproofThreshold = std::min(disproofThreshold, secondBest + 1);
+        }
+
+        uint32_t childProof;
+        uint32_t childDisproof;
+        mid(children[best], !attacker, childProofThreshold, childDisproofThreshold, childProof, childDisproof);
+    }
+
+    store(board, attacker, proof, disproof);
+}
+
+/**
+ * Helper method to answer the question of a node without searching it, if possible. A node is answered if the player
+ * to move wins right away, can not avoid losing with the next move of the opponent or the field is about to be full.
+ *
+ * \param board The position.
+ * \param attacker Indicates if the attacker is the player to move.
+ * \param moves Receives the moves of the player to move that do not lose right away, if the node is not answered.
+ * \param proof Receives the proof number, if the node is answered.
+ * \param disproof Receives the disproof number, if the node is answered.
+ * \return Returns true if the node is answered.
+ */
+bool ProofNumberSearch::evaluateTerminal(const Bitboard& board, bool attacker, uint64_t& moves, uint32_t& proof,
+    uint32_t& disproof)
+{
+    // Does the player to move win?
+    bool playerWins;
+    moves = board.possibleNonLosingMoves();
+    if (board.winningPositions() & board.possibleMoves())
+        playerWins = true;
+    else if (moves == 0)
+        playerWins = false;
+    else if (board.moveCount() >= FIELD_WIDTH * FIELD_HEIGHT - 2)
+    {
+        // Nobody wins, which is a failed proof for the attacker.
+        proof = PROOF_NUMBER_INFINITY;
+        disproof = 0;
+        return true;
+    }
+    else
+        return false;
+
+    bool attackerWins = playerWins == attacker;
+    proof = attackerWins ? 0 : PROOF_NUMBER_INFINITY;
+    disproof = attackerWins ? PROOF_NUMBER_INFINITY : 0;
+    return true;
+}
+
+/**
+ * Helper method to read the numbers of a node from the table. Unknown nodes start with 1 and 1.
+ *
+ * \param board The position.
+ * \param attacker Indicates if the attacker is the player to move.
+ * \param proof Receives the proof number.
+ * \param disproof Receives the disproof number.
+ */
+void ProofNumberSearch::lookup(const Bitboard& board, bool attacker, uint32_t& proof, uint32_t& disproof)
+{
+    uint64_t key = board.key() | (attacker ? PROOF_NUMBER_KEY_ATTACKER : 0);
+    const Entry& entry = m_table[hashKey(key) & m_tableMask];
+    if (entry.key == key)
+    {
+        proof = entry.proof;
+        disproof = entry.disproof;
+    }
+    else
+    {
+        proof = 1;
+        disproof = 1;
+    }
+}
+
+/**
+ * Helper method to write the numbers of a node to the table. The entry that was there before is replaced.
+ *
+ * \param board The position.
+ * \param attacker Indicates if the attacker is the player to move.
+ * \param proof The proof number.
+ * \param disproof The disproof number.
+ */
+void ProofNumberSearch::store(const Bitboard& board, bool attacker, uint32_t proof, uint32_t disproof)
+{
+    uint64_t key = board.key() | (attacker ? PROOF_NUMBER_KEY_ATTACKER : 0);
+    Entry& entry = m_table[hashKey(key) & m_tableMask];
+    entry.key = key;
+    entry.proof = proof;
+    entry.disproof = disproof;
+}
+
+/**
+ * Helper method to follow a proof through the table. The attacker plays a proven move, the defender the first of its
+ * moves. The line ends early if a part of the proof was replaced in the table.
+ *
+ * \param board The proven position.
+ * \param attacker Indicates if the attacker is the player to move.
+ * \param line Receives the moves. Columns start at 0.
+ */
+void ProofNumberSearch::getLine(Bitboard board, bool attacker, std::vector<int>& line)
+{
+    while (!board.isFull())
+    {
+        uint64_t winningMoves = board.winningPositions() & board.possibleMoves();
+        uint64_t moves = board.possibleNonLosingMoves();
+        int next = -1;
+        for (int column = 0; column < FIELD_WIDTH && next == -1; column++)
+        {
+            if (winningMoves & Bitboard::columnMask(column))
+            {
+                line.push_back(column);
+                return;
+            }
+        }
+
+        // A defender without a move that holds loses with every move.
+        bool lost = !attacker && moves == 0;
+        if (lost)
+            moves = board.possibleMoves();
+
+        for (int column = 0; column < FIELD_WIDTH && next == -1; column++)
+        {
+            if (!(moves & Bitboard::columnMask(column)))
+                continue;
+
+            Bitboard child = board;
+            child.play(column);
+            uint32_t proof;
+            uint32_t disproof;
+            lookup(child, !attacker, proof, disproof);
+            if (proof == 0 || lost)
+                next = column;
+        }
+
+        if (next == -1)
+            return;
+
+        line.push_back(next);
+        board.play(next);
+        attacker = !attacker;
+    }
+}
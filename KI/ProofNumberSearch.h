@@ -0,0 +1,72 @@
+#ifndef PROOFNUMBERSEARCH_H
+#define PROOFNUMBERSEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Bitboard.h"
+
+// Default number of entries of the table, 4 MB.
+constexpr size_t PROOF_NUMBER_DEFAULT_TABLE_SIZE = size_t(1) << 18;
+constexpr size_t PROOF_NUMBER_ENTRY_BYTES = 16;
+
+// Depth-first proof-number search (df-pn). It answers whether the player to move can force a win or will lose, and
+// spends its nodes where the proof looks cheapest instead of searching every branch to the same depth. Narrow forced
+// wins far beyond the depth of Algorithm are found with few nodes.
+// Proof and disproof numbers are stored in a table, so a position reached by several orders of moves is only searched
+// once. Connect 4 has no cycles, so the table needs no special handling for repeated positions.
+class ProofNumberSearch
+{
+public:
+    enum class Result
+    {
+        Unknown,    // The node budget was used up before the question was answered
+        Win,        // The player to move can force a win
+        Loss,       // The opponent can force a win
+        Draw,       // Nobody can force a win
+        NoWin       // Only the win was searched and the player to move can not force it
+    };
+
+    // Is polled during the search. Returning true stops it with Result::Unknown.
+    using StopCallback = std::function<bool()>;
+
+    ProofNumberSearch(size_t tableSize = PROOF_NUMBER_DEFAULT_TABLE_SIZE);
+
+    Result prove(const Bitboard& board, uint64_t maxNodes, std::vector<int>& line, const StopCallback& stop = nullptr);
+    Result proveWin(const Bitboard& board, uint64_t maxNodes, std::vector<int>& line,
+        const StopCallback& stop = nullptr);
+    uint64_t getNodeCount();
+    void clear();
+
+    static size_t entriesForBudget(size_t bytes);
+
+private:
+    struct Entry
+    {
+        uint64_t    key         = 0;
+        uint32_t    proof       = 0;
+        uint32_t    disproof    = 0;
+    };
+
+    static_assert(sizeof(Entry) == PROOF_NUMBER_ENTRY_BYTES, "Unexpected entry size");
+
+    void mid(const Bitboard& board, bool attacker, uint32_t proofThreshold, uint32_t disproofThreshold,
+        uint32_t& proof, uint32_t& disproof);
+    static bool evaluateTerminal(const Bitboard& board, bool attacker, uint64_t& moves, uint32_t& proof,
+        uint32_t& disproof);
+    void lookup(const Bitboard& board, bool attacker, uint32_t& proof, uint32_t& disproof);
+    void store(const Bitboard& board, bool attacker, uint32_t proof, uint32_t disproof);
+    void getLine(Bitboard board, bool attacker, std::vector<int>& line);
+    bool isOutOfBudget();
+
+    std::unique_ptr<Entry[]>    m_table;
+    size_t                      m_tableMask;
+    uint64_t                    m_nodeCount     = 0;
+    uint64_t                    m_maxNodes      = 0;
+    const StopCallback*         m_stop          = nullptr;
+    uint64_t                    m_nextStopCheck = 0;
+};
+
+#endif
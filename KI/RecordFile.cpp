@@ -0,0 +1,551 @@
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "RecordFile.h"
+
+// Records are collected in memory and written in blocks of this size.
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 16;
+
+/**
+ * Helper function to cut a file off after a number of bytes.
+ *
+ * \param path The path of the file.
+ * \param size The new size of the file.
+ * \return Returns true if the operation was successful.
+ */
+static bool truncateFile(const std::string& path, size_t size)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER end{};
+    end.QuadPart = static_cast<LONGLONG>(size);
+    bool success = SetFilePointerEx(file, end, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+    CloseHandle(file);
+    return success;
+#else
+    return ::truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+}
+
+/**
+ * Helper function to find the end of the last complete record. A writer that crashed can leave a record behind that
+ * was only written in part.
+ *
+ * \param path The path of an existing record file with a valid header.
+ * \param size Receives the size of the header and all complete records.
+ * \return Returns true if the operation was successful.
+ */
+static bool completeRecordsSize(const std::string& path, size_t& size)
+{
+    RecordReader reader;
+    if (!reader.open(path))
+        return false;
+
+    size = sizeof(RecordFileHeader);
+    if (reader.type() == RecordType::Position)
+    {
+        size += reader.positionCount() * sizeof(PositionRecord);
+    }
+    else
+    {
+        for (GameView game : reader.games())
+        {
+            size += game.byteSize();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Public constructor.
+ *
+ * \param data Pointer to the first byte of a game record. The data has to outlive the view.
+ */
+GameView::GameView(const uint8_t* data) : m_data(data)
+{
+}
+
+/**
+ * Getter for the number of moves in the game.
+ *
+ * \return Returns the number of moves.
+ */
+int GameView::moveCount() const
+{
+    return m_data[0];
+}
+
+/**
+ * Getter for a single move of the game.
+ *
+ * \param index The index of the move starting at 0.
+ * \return Returns the column of the move starting at 1.
+ */
+int GameView::move(int index) const
+{
+    uint8_t packed = m_data[2 + index / 2];
+    return index % 2 == 0 ? packed & 0x0F : packed >> 4;
+}
+
+/**
+ * Unpacks all moves of the game.
+ *
+ * \return Returns the columns of all moves in the order they were played.
+ */
+std::vector<int> GameView::moves() const
+{
+    std::vector<int> returnValue;
+    returnValue.reserve(moveCount());
+    for (int index = 0; index < moveCount(); index++)
+    {
+        returnValue.push_back(move(index));
+    }
+
+    return returnValue;
+}
+
+/**
+ * Getter for the final state of the game.
+ *
+ * \return Returns the state the game ended in.
+ */
+Field::GameState GameView::result() const
+{
+    return static_cast<Field::GameState>(m_data[1] & 0x03);
+}
+
+/**
+ * Getter for the player that started the game.
+ *
+ * \return Returns the player that made the first move.
+ */
+Field::Player GameView::firstPlayer() const
+{
+    return (m_data[1] & 0x04) ? Field::Player::Algorithm : Field::Player::Human;
+}
+
+/**
+ * Replays all moves of the game on a new field.
+ *
+ * \return Returns the field after the last move.
+ */
+Field GameView::replay() const
+{
+    Field field;
+    Field::Player player = firstPlayer();
+    for (int index = 0; index < moveCount(); index++)
+    {
+        field.placeStone(move(index), player);
+        player = player == Field::Player::Human ? Field::Player::Algorithm : Field::Player::Human;
+    }
+
+    return field;
+}
+
+/**
+ * Gives info about the size of the record.
+ *
+ * \return Returns the number of bytes the record occupies in the file.
+ */
+size_t GameView::byteSize() const
+{
+    return 2 + (static_cast<size_t>(moveCount()) + 1) / 2;
+}
+
+/**
+ * Public constructor.
+ *
+ */
+RecordWriter::RecordWriter()
+{
+}
+
+/**
+ * Destructor. Writes all buffered records.
+ *
+ */
+RecordWriter::~RecordWriter()
+{
+    close();
+}
+
+/**
+ * Opens a record file for writing.
+ *
+ * \param path The path of the file.
+ * \param type The type of the records that will be written.
+ * \param append If true, records are added to an existing file of the same type. A record at the end of the file that
+ * was only written in part is removed first. A missing or empty file is created like it would be without append.
+ * \return Returns true if the file can be written. False means, that the file could not be opened or that an existing
+ * file has a different type or version.
+ */
+bool RecordWriter::open(const std::string& path, RecordType type, bool append)
+{
+    close();
+    m_type = type;
+    m_buffer.reserve(WRITE_BUFFER_SIZE);
+
+    if (append)
+    {
+        std::ifstream existing(path, std::ios::binary | std::ios::ate);
+        size_t fileSize = static_cast<size_t>(existing.tellg());
+        existing.seekg(0);
+        RecordFileHeader header{};
+        if (existing.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            if (header.magic != RECORD_FILE_MAGIC || header.version != RECORD_FILE_VERSION || header.type != type)
+                return false;
+
+            // New records have to start right after the last complete one, otherwise every record behind a cut off
+            // one would be misread.
+            existing.close();
+            size_t completeSize = 0;
+            if (!completeRecordsSize(path, completeSize)
+                || (completeSize != fileSize && !truncateFile(path, completeSize)))
+                return false;
+
+            m_stream.open(path, std::ios::binary | std::ios::app);
+            return m_stream.is_open();
+        }
+    }
+
+    m_stream.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_stream.is_open())
+        return false;
+
+    RecordFileHeader header{ RECORD_FILE_MAGIC, RECORD_FILE_VERSION, type };
+    return writeBytes(&header, sizeof(header));
+}
+
+/**
+ * Appends a position record.
+ *
+ * \param record The record to write.
+ * \return Returns true if the operation was successful. False means, that the file is not open for positions.
+ */
+bool RecordWriter::write(const PositionRecord& record)
+{
+    if (!m_stream.is_open() || m_type != RecordType::Position)
+        return false;
+
+    return writeBytes(&record, sizeof(record));
+}
+
+/**
+ * Appends a game record.
+ *
+ * \param moves The columns of all moves starting at 1, in the order they were played.
+ * \param result The state the game ended in.
+ * \param firstPlayer The player that made the first move.
+ * \return Returns true if the operation was successful. False means, that the file is not open for games or that a
+ * move can not be stored.
+ */
+bool RecordWriter::write(const std::vector<int>& moves, Field::GameState result, Field::Player firstPlayer)
+{
+    if (!m_stream.is_open() || m_type != RecordType::Game || moves.size() > FIELD_WIDTH * FIELD_HEIGHT)
+        return false;
+
+    uint8_t record[2 + (FIELD_WIDTH * FIELD_HEIGHT + 1) / 2] = {};
+    record[0] = static_cast<uint8_t>(moves.size());
+    record[1] = static_cast<uint8_t>(result) | (firstPlayer == Field::Player::Algorithm ? 0x04 : 0x00);
+    for (size_t index = 0; index < moves.size(); index++)
+    {
+        if (moves[index] < 1 || moves[index] > FIELD_WIDTH)
+            return false;
+
+        record[2 + index / 2] |= static_cast<uint8_t>(moves[index] << (index % 2 == 0 ? 0 : 4));
+    }
+
+    return writeBytes(record, 2 + (moves.size() + 1) / 2);
+}
+
+/**
+ * Writes all buffered records to the file.
+ *
+ * \return Returns true if the operation was successful.
+ */
+bool RecordWriter::flush()
+{
+    if (!m_stream.is_open())
+        return false;
+
+    m_stream.write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+    m_stream.flush();
+    return m_stream.good();
+}
+
+/**
+ * Writes all buffered records and closes the file.
+ *
+ */
+void RecordWriter::close()
+{
+    if (!m_stream.is_open())
+        return;
+
+    flush();
+    m_stream.close();
+}
+
+/**
+ * Indicates if the writer has an open file.
+ *
+ * \return Returns true if records can be written.
+ */
+bool RecordWriter::isOpen()
+{
+    return m_stream.is_open();
+}
+
+/**
+ * Helper method to add bytes to the write buffer.
+ *
+ * \param data The bytes to add.
+ * \param size The number of bytes.
+ * \return Returns true if the operation was successful.
+ */
+bool RecordWriter::writeBytes(const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+
+    if (m_buffer.size() >= WRITE_BUFFER_SIZE)
+        return flush();
+
+    return true;
+}
+
+/**
+ * Public constructor.
+ *
+ * \param position The first byte of the current record.
+ * \param end The first byte after the mapped file.
+ */
+RecordReader::GameIterator::GameIterator(const uint8_t* position, const uint8_t* end)
+    : m_position(position), m_end(end)
+{
+    // A record that was cut off (e.g. by a crashed writer) ends the iteration.
+    if (m_position != m_end && (m_end - m_position < 2 || GameView(m_position).byteSize() > size_t(m_end - m_position)))
+        m_position = m_end;
+}
+
+/**
+ * Access to the current game.
+ *
+ * \return Returns a view on the current game. The view is valid as long as the reader is open.
+ */
+GameView RecordReader::GameIterator::operator*() const
+{
+    return GameView(m_position);
+}
+
+/**
+ * Moves on to the next game.
+ *
+ * \return Returns the iterator itself.
+ */
+RecordReader::GameIterator& RecordReader::GameIterator::operator++()
+{
+    *this = GameIterator(m_position + GameView(m_position).byteSize(), m_end);
+    return *this;
+}
+
+/**
+ * Compares two iterators.
+ *
+ * \param other The iterator to compare with.
+ * \return Returns true if the iterators point to different records.
+ */
+bool RecordReader::GameIterator::operator!=(const GameIterator& other) const
+{
+    return m_position != other.m_position;
+}
+
+/**
+ * Public constructor.
+ *
+ */
+RecordReader::RecordReader()
+{
+}
+
+/**
+ * Destructor. Unmaps the file.
+ *
+ */
+RecordReader::~RecordReader()
+{
+    close();
+}
+
+/**
+ * Maps a record file into memory. The records are read directly from the mapping without copying them.
+ *
+ * \param path The path of the file.
+ * \return Returns true if the operation was successful. False means, that the file could not be mapped or is not a
+ * record file of a known version.
+ */
+bool RecordReader::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(RecordFileHeader))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat fileInfo {};
+    if (fstat(file, &fileInfo) != 0 || fileInfo.st_size < (off_t)sizeof(RecordFileHeader))
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    madvise(data, fileInfo.st_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(fileInfo.st_size);
+#endif
+
+    RecordFileHeader header{};
+    std::memcpy(&header, m_data, sizeof(header));
+    if (header.magic != RECORD_FILE_MAGIC || header.version != RECORD_FILE_VERSION
+        || (header.type != RecordType::Position && header.type != RecordType::Game))
+    {
+        close();
+        return false;
+    }
+
+    m_type = header.type;
+    return true;
+}
+
+/**
+ * Unmaps the file. All views and iterators of the reader become invalid.
+ *
+ */
+void RecordReader::close()
+{
+    if (m_data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+/**
+ * Indicates if the reader has a mapped file.
+ *
+ * \return Returns true if records can be read.
+ */
+bool RecordReader::isOpen()
+{
+    return m_data != nullptr;
+}
+
+/**
+ * Getter for the type of the records in the file.
+ *
+ * \return Returns the record type from the file header.
+ */
+RecordType RecordReader::type()
+{
+    return m_type;
+}
+
+/**
+ * Gives info about the number of position records.
+ *
+ * \return Returns the number of complete position records. 0 if the file does not contain positions.
+ */
+size_t RecordReader::positionCount()
+{
+    if (m_data == nullptr || m_type != RecordType::Position)
+        return 0;
+
+    return (m_size - sizeof(RecordFileHeader)) / sizeof(PositionRecord);
+}
+
+/**
+ * Access to all position records. The records point directly into the mapped file.
+ *
+ * \return Returns a range that can be used in a range based for loop. The range is empty if the file does not contain
+ * positions.
+ */
+RecordReader::Range<const PositionRecord*> RecordReader::positions()
+{
+    if (positionCount() == 0)
+        return { nullptr, nullptr };
+
+    const PositionRecord* first = reinterpret_cast<const PositionRecord*>(m_data + sizeof(RecordFileHeader));
+    return { first, first + positionCount() };
+}
+
+/**
+ * Access to all game records. The games point directly into the mapped file.
+ *
+ * \return Returns a range that can be used in a range based for loop. The range is empty if the file does not contain
+ * games.
+ */
+RecordReader::Range<RecordReader::GameIterator> RecordReader::games()
+{
+    const uint8_t* end = m_data + m_size;
+    if (m_data == nullptr || m_type != RecordType::Game)
+        return { GameIterator(end, end), GameIterator(end, end) };
+
+    return { GameIterator(m_data + sizeof(RecordFileHeader), end), GameIterator(end, end) };
+}
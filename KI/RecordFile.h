@@ -0,0 +1,146 @@
+#ifndef RECORDFILE_H
+#define RECORDFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Field.h"
+
+// Binary record files start with a RecordFileHeader followed by records of a single RecordType. All values are
+// stored little endian, which is what every platform we build for uses natively, so records can be read in place.
+//  |header|record|record|record|...
+constexpr uint32_t RECORD_FILE_MAGIC = 0x42523443; // "C4RB"
+constexpr uint16_t RECORD_FILE_VERSION = 1;
+
+enum class RecordType : uint16_t
+{
+    Position = 1,
+    Game = 2
+};
+
+// Bits for PositionRecord::flags.
+constexpr uint8_t RECORD_FLAG_EXACT = 0x01;
+constexpr uint8_t RECORD_FLAG_LOWER_BOUND = 0x02;
+constexpr uint8_t RECORD_FLAG_UPPER_BOUND = 0x04;
+constexpr uint8_t RECORD_FLAG_SOLVED = 0x08;
+constexpr uint8_t RECORD_FLAG_ALGORITHM_TO_MOVE = 0x10;
+// The score is a Solver score of the player to move instead of a Node value.
+constexpr uint8_t RECORD_FLAG_SOLVER_SCORE = 0x20;
+
+struct RecordFileHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    RecordType type;
+};
+
+// A single analysed position. The score is seen from the algorithm's side, like the values of the Node tree, unless
+// RECORD_FLAG_SOLVER_SCORE is set.
+struct PositionRecord
+{
+    uint64_t key;       // Packed position, see Field::getKey
+    int32_t  score;
+    uint8_t  move;      // Best column starting at 1, 0 if there is none
+    uint8_t  flags;     // RECORD_FLAG_*
+    uint16_t depth;     // Search depth the score was computed with
+};
+
+static_assert(sizeof(RecordFileHeader) == 8, "RecordFileHeader must stay 8 bytes");
+static_assert(sizeof(PositionRecord) == 16, "PositionRecord must stay 16 bytes");
+
+// A game is stored as a variable length record:
+//  |move count|info|moves packed two per byte, low nibble first|
+// The info byte holds the final Field::GameState in bits 0-1 and the player that made the first move in bit 2.
+class GameView
+{
+public:
+    GameView(const uint8_t* data = nullptr);
+
+    int moveCount() const;
+    int move(int index) const;
+    std::vector<int> moves() const;
+    Field::GameState result() const;
+    Field::Player firstPlayer() const;
+    Field replay() const;
+    size_t byteSize() const;
+
+private:
+    const uint8_t* m_data;
+};
+
+class RecordWriter
+{
+public:
+    RecordWriter();
+    ~RecordWriter();
+
+    bool open(const std::string& path, RecordType type, bool append = false);
+    bool write(const PositionRecord& record);
+    bool write(const std::vector<int>& moves, Field::GameState result, Field::Player firstPlayer);
+    bool flush();
+    void close();
+    bool isOpen();
+
+private:
+    bool writeBytes(const void* data, size_t size);
+
+    std::ofstream           m_stream;
+    std::vector<char>       m_buffer;
+    RecordType              m_type      = RecordType::Position;
+};
+
+class RecordReader
+{
+public:
+    class GameIterator
+    {
+    public:
+        GameIterator(const uint8_t* position, const uint8_t* end);
+
+        GameView operator*() const;
+        GameIterator& operator++();
+        bool operator!=(const GameIterator& other) const;
+
+    private:
+        const uint8_t* m_position;
+        const uint8_t* m_end;
+    };
+
+    template <typename Iterator>
+    struct Range
+    {
+        Iterator first;
+        Iterator last;
+
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+    };
+
+    RecordReader();
+    ~RecordReader();
+
+    RecordReader(const RecordReader&) = delete;
+    RecordReader& operator=(const RecordReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen();
+    RecordType type();
+
+    size_t positionCount();
+    Range<const PositionRecord*> positions();
+    Range<GameIterator> games();
+
+private:
+    const uint8_t*  m_data      = nullptr;
+    size_t          m_size      = 0;
+    RecordType      m_type      = RecordType::Position;
+#ifdef _WIN32
+    void*           m_file      = nullptr;
+    void*           m_mapping   = nullptr;
+#endif
+};
+
+#endif
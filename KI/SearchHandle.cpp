@@ -0,0 +1,63 @@
+#include "SearchHandle.h"
+
+/**
+ * Public constructor.
+ *
+ * \param result The future that receives the move of the search.
+ * \param cancelToken The token the search checks for cancellation.
+ */
+SearchHandle::SearchHandle(std::shared_future<int> result, std::shared_ptr<std::atomic<bool>> cancelToken)
+    : m_result(result), m_cancelToken(cancelToken)
+{
+}
+
+/**
+ * Asks the search to stop. The search ends within a few nodes and still delivers the best move of the last completed
+ * depth. This method does not wait for the search, use SearchHandle::get for that.
+ *
+ */
+void SearchHandle::cancel()
+{
+    m_cancelToken->store(true, std::memory_order_relaxed);
+}
+
+/**
+ * Indicates if the search was asked to stop.
+ *
+ * \return Returns true if SearchHandle::cancel was called.
+ */
+bool SearchHandle::isCancelled()
+{
+    return m_cancelToken->load(std::memory_order_relaxed);
+}
+
+/**
+ * Indicates if the result of the search is available.
+ *
+ * \return Returns true if SearchHandle::get will not block.
+ */
+bool SearchHandle::isReady()
+{
+    return waitFor(std::chrono::milliseconds(0));
+}
+
+/**
+ * Waits for the search to finish.
+ *
+ * \param timeout The maximum time to wait.
+ * \return Returns true if the search finished in time.
+ */
+bool SearchHandle::waitFor(std::chrono::milliseconds timeout)
+{
+    return m_result.wait_for(timeout) == std::future_status::ready;
+}
+
+/**
+ * Waits for the search to finish and returns its move.
+ *
+ * \return The number of the column the algorithm wants to make its next move in, see Algorithm::getNextMove.
+ */
+int SearchHandle::get()
+{
+    return m_result.get();
+}
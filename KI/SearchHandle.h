@@ -0,0 +1,38 @@
+#ifndef SEARCHHANDLE_H
+#define SEARCHHANDLE_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+
+// Snapshot of a running search, reported after every completed depth.
+struct SearchProgress
+{
+    int     depth       = 0;
+    int     bestMove    = -1;
+    int     bestValue   = 0;
+    double  elapsedMs   = 0;
+};
+
+using ProgressCallback = std::function<void(const SearchProgress&)>;
+
+// Handle to a search that runs in the background, see Algorithm::getNextMoveAsync.
+class SearchHandle
+{
+public:
+    SearchHandle(std::shared_future<int> result, std::shared_ptr<std::atomic<bool>> cancelToken);
+
+    void cancel();
+    bool isCancelled();
+    bool isReady();
+    bool waitFor(std::chrono::milliseconds timeout);
+    int get();
+
+private:
+    std::shared_future<int>                 m_result;
+    std::shared_ptr<std::atomic<bool>>      m_cancelToken;
+};
+
+#endif
@@ -0,0 +1,420 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "Algorithm.h"
+#include "SelfPlayGenerator.h"
+#include "Solver.h"
+
+// Number of records a thread collects per shard before it takes the lock of the shard and writes them.
+constexpr size_t SELF_PLAY_WRITE_BATCH = 4096;
+
+struct SelfPlayGenerator::Shard
+{
+    std::mutex      mutex;
+    RecordWriter    writer;
+};
+
+/**
+ * Helper function to spread the packed keys, whose lower bits are mostly zero, over the key set and the shards.
+ *
+ * \param key The key to hash.
+ * \return Returns the hashed key.
+ */
+static uint64_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * Helper function to pick a random column out of a set of moves.
+ *
+ * \param random The random number generator of the calling thread.
+ * \param moves The moves as returned by Bitboard::possibleMoves. Must not be 0.
+ * \return Returns the column starting at 0.
+ */
+static int pickColumn(std::mt19937& random, uint64_t moves)
+{
+    int columns[FIELD_WIDTH];
+    int count = 0;
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        if (moves & Bitboard::columnMask(column))
+            columns[count++] = column;
+    }
+
+    return columns[random() % count];
+}
+
+/**
+ * Helper function to play a single game and sample positions from it. Both players take an immediate win and
+ * otherwise play a random move that does not allow the opponent to win right away. That is much cheaper than a search
+ * per move and still avoids the hopeless positions of purely random games.
+ *
+ * \param random The random number generator of the calling thread.
+ * \param minStones Positions with fewer stones are not sampled.
+ * \param samplesPerGame The maximum number of sampled positions.
+ * \param samples Receives the sampled positions. None of them is over.
+ */
+static void playGame(std::mt19937& random, int minStones, int samplesPerGame, std::vector<Bitboard>& samples)
+{
+    samples.clear();
+    Bitboard board;
+    int candidates = 0;
+
+    while (!board.isFull())
+    {
+        // Reservoir sampling, so every position of the game has the same chance to be picked.
+        if (board.moveCount() >= minStones)
+        {
+            candidates++;
+            if ((int)samples.size() < samplesPerGame)
+                samples.push_back(board);
+            else if ((int)(random() % candidates) < samplesPerGame)
+                samples[random() % samplesPerGame] = board;
+        }
+
+        uint64_t winningMoves = board.winningPositions() & board.possibleMoves();
+        if (winningMoves)
+            break;
+
+        uint64_t moves = board.possibleNonLosingMoves();
+        if (moves == 0)
+            break;
+
+        board.play(pickColumn(random, moves));
+    }
+}
+
+/**
+ * Helper function to label a position with the exact solver.
+ *
+ * \param solver The solver of the calling thread.
+ * \param board The position.
+ * \param record Receives the label.
+ */
+static void labelWithSolver(Solver& solver, const Bitboard& board, PositionRecord& record)
+{
+    int scores[FIELD_WIDTH];
+    solver.analyze(board, scores);
+
+    int bestColumn = -1;
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        if (scores[column] != SOLVER_INVALID_SCORE && (bestColumn == -1 || scores[column] > scores[bestColumn]))
+            bestColumn = column;
+    }
+
+    record.key = board.key();
+    record.score = scores[bestColumn];
+    record.move = (uint8_t)(bestColumn + 1);
+    record.flags = RECORD_FLAG_EXACT | RECORD_FLAG_SOLVED | RECORD_FLAG_ALGORITHM_TO_MOVE | RECORD_FLAG_SOLVER_SCORE;
+    record.depth = (uint16_t)(FIELD_WIDTH * FIELD_HEIGHT - board.moveCount());
+}
+
+/**
+ * Helper function to label a position with a minimax search. The player to move plays as Field::Player::Algorithm.
+ *
+ * \param algorithm The algorithm of the calling thread.
+ * \param board The position.
+ * \param timeBudgetMs The time budget of the search.
+ * \param record Receives the label.
+ */
+static void labelWithSearch(Algorithm& algorithm, const Bitboard& board, int timeBudgetMs, PositionRecord& record)
+{
+    Field field;
+    field.setKey(board.key());
+    int column = algorithm.getNextMove(field, timeBudgetMs);
+    int value = algorithm.getBestValue();
+
+    record.key = board.key();
+    record.score = (int32_t)value;
+    record.move = (uint8_t)column;
+    record.flags = RECORD_FLAG_EXACT | RECORD_FLAG_ALGORITHM_TO_MOVE;
+    if (value == INT_MAX || value == INT_MIN)
+        record.flags |= RECORD_FLAG_SOLVED;
+    record.depth = (uint16_t)algorithm.getCompletedDepth();
+}
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the generator.
+ */
+SelfPlayGenerator::SelfPlayGenerator(const Options& options) : m_options(options)
+{
+}
+
+/**
+ * Destructor.
+ *
+ */
+SelfPlayGenerator::~SelfPlayGenerator()
+{
+}
+
+/**
+ * Generates positions until Options::positions new ones are written.
+ *
+ * \param report Receives the results.
+ * \return Returns true if the operation was successful. False means, that a shard could not be opened or written.
+ */
+bool SelfPlayGenerator::run(Report& report)
+{
+    report = Report();
+    m_positions = 0;
+    m_duplicates = 0;
+    m_games = 0;
+    m_finishedThreads = 0;
+    m_failed = false;
+    if (m_options.shards < 1 || m_options.samplesPerGame < 1 || m_options.minStones >= FIELD_WIDTH * FIELD_HEIGHT)
+        return false;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!openShards(report))
+        return false;
+
+    size_t threadCount = m_options.threads > 0 ? m_options.threads
+        : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<std::thread> threads;
+    for (size_t threadNr = 0; threadNr < threadCount; threadNr++)
+        threads.emplace_back(&SelfPlayGenerator::runThread, this, threadNr);
+
+    std::chrono::steady_clock::time_point nextProgress = start + std::chrono::seconds(m_options.progressSeconds);
+    while (m_finishedThreads < threadCount)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (m_options.progressSeconds > 0 && now >= nextProgress)
+        {
+            double seconds = std::chrono::duration<double>(now - start).count();
+            uint64_t positions = std::min(m_positions.load(), m_options.positions);
+            std::cout << positions << " / " << m_options.positions << " positions, " << std::fixed
+                << std::setprecision(0) << positions / seconds << "/s" << std::endl;
+            nextProgress = now + std::chrono::seconds(m_options.progressSeconds);
+        }
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    bool success = !m_failed;
+    for (std::unique_ptr<Shard>& shard : m_shards)
+        success = shard->writer.flush() && success;
+    m_shards.clear();
+    m_keys.reset();
+
+    report.positions = std::min(m_positions.load(), m_options.positions);
+    report.duplicates = m_duplicates;
+    report.games = m_games;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return success;
+}
+
+/**
+ * Prints the results of a run.
+ *
+ * \param report The results.
+ */
+void SelfPlayGenerator::printReport(const Report& report)
+{
+    double seconds = std::max(report.seconds, 0.001);
+    std::cout << "positions:    " << report.positions << " (" << std::fixed << std::setprecision(0)
+        << report.positions / seconds << "/s, " << report.positions / seconds * 3600 << "/h)" << std::endl
+        << "existing:     " << report.existingPositions << std::endl
+        << "duplicates:   " << report.duplicates << std::endl
+        << "games:        " << report.games << std::endl
+        << "seconds:      " << std::setprecision(1) << report.seconds << std::endl;
+}
+
+/**
+ * Gives the path of a shard.
+ *
+ * \param output The path of the output. A single shard is written to it directly.
+ * \param shardNr The index of the shard.
+ * \param shards The number of shards.
+ * \return Returns the path, e.g. "selfplay.3.c4rb" for the shard 3 of "selfplay.c4rb".
+ */
+std::string SelfPlayGenerator::shardPath(const std::string& output, int shardNr, int shards)
+{
+    if (shards == 1)
+        return output;
+
+    size_t extension = output.find_last_of('.');
+    size_t separator = output.find_last_of("/\\");
+    if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+        return output + "." + std::to_string(shardNr);
+
+    return output.substr(0, extension) + "." + std::to_string(shardNr) + output.substr(extension);
+}
+
+/**
+ * Helper method to open all shards and to create the set of keys. When appending, the keys that are already in the
+ * shards are added to the set, so they are not written again.
+ *
+ * \param report Receives the number of existing positions.
+ * \return Returns true if the operation was successful.
+ */
+bool SelfPlayGenerator::openShards(Report& report)
+{
+    std::vector<RecordReader> readers(m_options.shards);
+    uint64_t existing = 0;
+    for (int shardNr = 0; m_options.append && shardNr < m_options.shards; shardNr++)
+    {
+        if (!readers[shardNr].open(shardPath(m_options.output, shardNr, m_options.shards)))
+            continue;
+        if (readers[shardNr].type() != RecordType::Position)
+            return false;
+        existing += readers[shardNr].positionCount();
+    }
+
+    // At most half of the slots are used, so the probe sequences stay short.
+    size_t slots = 2;
+    while (slots < 2 * (existing + m_options.positions))
+        slots *= 2;
+    m_keys.reset(new std::atomic<uint64_t>[slots]);
+    for (size_t slot = 0; slot < slots; slot++)
+        m_keys[slot].store(0, std::memory_order_relaxed);
+    m_keyMask = slots - 1;
+
+    for (RecordReader& reader : readers)
+    {
+        if (!reader.isOpen())
+            continue;
+        for (const PositionRecord& record : reader.positions())
+            insertKey(record.key);
+        reader.close();
+    }
+    report.existingPositions = existing;
+
+    m_shards.clear();
+    for (int shardNr = 0; shardNr < m_options.shards; shardNr++)
+    {
+        m_shards.emplace_back(new Shard());
+        if (!m_shards.back()->writer.open(shardPath(m_options.output, shardNr, m_options.shards), RecordType::Position,
+            m_options.append))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Helper method that plays games on one thread until enough positions are written.
+ *
+ * \param threadNr The index of the thread, used to give every thread its own games.
+ */
+void SelfPlayGenerator::runThread(size_t threadNr)
+{
+    std::mt19937 random(m_options.seed + (uint32_t)threadNr * 7919);
+    std::unique_ptr<Solver> solver;
+    std::unique_ptr<Algorithm> algorithm;
+    if (m_options.label == Label::Solver)
+    {
+        solver.reset(new Solver(m_options.solverTableSize));
+    }
+    else
+    {
+        algorithm.reset(new Algorithm());
+        algorithm->setMemoryBudget(m_options.memoryBudgetMb);
+    }
+
+    std::vector<std::vector<PositionRecord>> pending(m_options.shards);
+    std::vector<Bitboard> samples;
+    bool done = false;
+    while (!done && !m_failed)
+    {
+        playGame(random, m_options.minStones, m_options.samplesPerGame, samples);
+        m_games++;
+
+        for (const Bitboard& board : samples)
+        {
+            if (!insertKey(board.key()))
+            {
+                m_duplicates++;
+                continue;
+            }
+
+            // Reserve the position before labeling it, so no thread labels more than is needed.
+            if (m_positions.fetch_add(1) >= m_options.positions)
+            {
+                done = true;
+                break;
+            }
+
+            PositionRecord record;
+            if (solver)
+                labelWithSolver(*solver, board, record);
+            else
+                labelWithSearch(*algorithm, board, m_options.timeBudgetMs, record);
+
+            std::vector<PositionRecord>& shardRecords = pending[hashKey(record.key) % m_options.shards];
+            shardRecords.push_back(record);
+            if (shardRecords.size() >= SELF_PLAY_WRITE_BATCH)
+                writeRecords(pending);
+        }
+    }
+
+    writeRecords(pending);
+    m_finishedThreads++;
+}
+
+/**
+ * Helper method to add a key to the set of written keys. This method can be called from multiple threads at the same
+ * time.
+ *
+ * \param key The packed key of the position. Must not be 0.
+ * \return Returns true if the key was added. False means, that the key was already in the set.
+ */
+bool SelfPlayGenerator::insertKey(uint64_t key)
+{
+    size_t slot = hashKey(key) & m_keyMask;
+    for (size_t probe = 0; probe <= m_keyMask; probe++)
+    {
+        uint64_t stored = m_keys[slot].load(std::memory_order_relaxed);
+        if (stored == key)
+            return false;
+        if (stored == 0)
+        {
+            if (m_keys[slot].compare_exchange_strong(stored, key, std::memory_order_relaxed))
+                return true;
+            if (stored == key)
+                return false;
+        }
+        slot = (slot + 1) & m_keyMask;
+    }
+
+    // The set is sized for all positions of the run, so it is never full. Treat it like a duplicate anyway.
+    return false;
+}
+
+/**
+ * Helper method to write the collected records of a thread to their shards.
+ *
+ * \param pending The records of every shard. They are removed after they were written.
+ */
+void SelfPlayGenerator::writeRecords(std::vector<std::vector<PositionRecord>>& pending)
+{
+    for (size_t shardNr = 0; shardNr < pending.size(); shardNr++)
+    {
+        if (pending[shardNr].empty())
+            continue;
+
+        Shard& shard = *m_shards[shardNr];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const PositionRecord& record : pending[shardNr])
+        {
+            if (!shard.writer.write(record))
+                m_failed = true;
+        }
+        pending[shardNr].clear();
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef SELFPLAYGENERATOR_H
+#define SELFPLAYGENERATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Engine.h"
+#include "RecordFile.h"
+
+// Default number of entries of the solver table of every thread, 16 MB.
+constexpr size_t SELF_PLAY_SOLVER_TABLE_SIZE = size_t(1) << 21;
+
+// Generates training data by playing randomized games on all cores and labeling positions sampled from them with a
+// score and the best move. Positions that were labeled before are skipped, so every position is written once, even if
+// several games or several runs with --append reach it.
+// The records are spread over shards by the hash of their key, so a position always lands in the same shard and the
+// shards can be processed independently.
+class SelfPlayGenerator
+{
+public:
+    enum class Label
+    {
+        Solver,     // Exact Solver score, only fast enough for positions with many stones
+        Search      // Score of the minimax Algorithm with a time budget per position
+    };
+
+    struct Options
+    {
+        size_t          threads             = 0;            // 0 means one per core
+        uint64_t        positions           = 100000;       // New positions to write
+        int             samplesPerGame      = 4;
+        Label           label               = Label::Solver;
+        int             minStones           = 20;           // Fewer stones are not sampled
+        int             timeBudgetMs        = 50;           // Per position, only used by Label::Search
+        size_t          memoryBudgetMb      = ENGINE_DEFAULT_MEMORY_BUDGET_MB;  // Per thread, Label::Search
+        size_t          solverTableSize     = SELF_PLAY_SOLVER_TABLE_SIZE;      // Per thread, Label::Solver
+        std::string     output              = "selfplay.c4rb";
+        int             shards              = 1;
+        bool            append              = false;
+        uint32_t        seed                = 1;
+        int             progressSeconds     = 10;           // 0 disables the progress output
+    };
+
+    struct Report
+    {
+        uint64_t        positions           = 0;    // Written records
+        uint64_t        existingPositions   = 0;    // Records that were already in the shards
+        uint64_t        duplicates          = 0;    // Sampled positions that were skipped
+        uint64_t        games               = 0;
+        double          seconds             = 0;
+    };
+
+    SelfPlayGenerator(const Options& options);
+    ~SelfPlayGenerator();
+
+    bool run(Report& report);
+    static void printReport(const Report& report);
+    static std::string shardPath(const std::string& output, int shardNr, int shards);
+
+private:
+    struct Shard;
+
+    bool openShards(Report& report);
+    void runThread(size_t threadNr);
+    bool insertKey(uint64_t key);
+    void writeRecords(std::vector<std::vector<PositionRecord>>& pending);
+
+    Options                                     m_options;
+    std::unique_ptr<std::atomic<uint64_t>[]>    m_keys;             // Set of all written keys, 0 is an empty slot
+    size_t                                      m_keyMask           = 0;
+    std::vector<std::unique_ptr<Shard>>         m_shards;
+    std::atomic<uint64_t>                       m_positions{ 0 };
+    std::atomic<uint64_t>                       m_duplicates{ 0 };
+    std::atomic<uint64_t>                       m_games{ 0 };
+    std::atomic<size_t>                         m_finishedThreads{ 0 };
+    std::atomic<bool>                           m_failed{ false };
+};
+
+#endif
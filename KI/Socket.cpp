@@ -0,0 +1,314 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+#include "Socket.h"
+
+#ifdef _WIN32
+using SocketHandle = uintptr_t;
+constexpr SocketHandle INVALID_HANDLE = INVALID_SOCKET;
+constexpr int SEND_FLAGS = 0;
+
+/**
+ * Helper function to initialize winsock once per process.
+ *
+ */
+static void initSockets()
+{
+    static bool initialized = []() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    (void)initialized;
+}
+
+static void closeHandle(uintptr_t handle)
+{
+    closesocket(handle);
+}
+#else
+using SocketHandle = int;
+constexpr SocketHandle INVALID_HANDLE = -1;
+
+// Writing to a connection the peer has closed raises SIGPIPE, which terminates the process. A closed connection has to
+// show up as a failed write instead.
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+static void initSockets()
+{
+}
+
+static void closeHandle(int handle)
+{
+    ::close(handle);
+}
+#endif
+
+/**
+ * Helper function to configure a connected socket.
+ *
+ * \param handle The socket.
+ */
+static void configureConnection(SocketHandle handle)
+{
+    // Messages are short and answered right away, so they should not be delayed.
+    int noDelay = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+#ifdef SO_NOSIGPIPE
+    // Systems without MSG_NOSIGNAL (macOS) suppress SIGPIPE per socket instead.
+    int noSignal = 1;
+    setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<const char*>(&noSignal), sizeof(noSignal));
+#endif
+}
+
+/**
+ * Helper function to resolve an IPv4 address.
+ *
+ * \param host The host name or address.
+ * \param port The port.
+ * \param address Receives the resolved address.
+ * \return Returns true if the host could be resolved.
+ */
+static bool resolve(const std::string& host, uint16_t port, sockaddr_in& address)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr)
+        return false;
+
+    address = *reinterpret_cast<sockaddr_in*>(result->ai_addr);
+    address.sin_port = htons(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+/**
+ * Public constructor.
+ *
+ */
+Socket::Socket() : m_handle(INVALID_HANDLE)
+{
+    initSockets();
+}
+
+/**
+ * Destructor. Closes the connection.
+ *
+ */
+Socket::~Socket()
+{
+    close();
+}
+
+/**
+ * Starts listening for connections.
+ *
+ * \param host The address to listen on, e.g. "127.0.0.1" to only accept local connections.
+ * \param port The port to listen on. 0 picks a free port, see Socket::localPort.
+ * \return Returns true if the operation was successful.
+ */
+bool Socket::listen(const std::string& host, uint16_t port)
+{
+    close();
+
+    sockaddr_in address{};
+    if (!resolve(host, port, address))
+        return false;
+
+    m_handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_handle == INVALID_HANDLE)
+        return false;
+
+    int reuse = 1;
+    setsockopt(m_handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    if (bind(m_handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(m_handle, SOMAXCONN) != 0)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Waits for the next connection of a client.
+ *
+ * \param client Receives the connection to the client.
+ * \return Returns true if a client connected. False means, that the socket is not listening anymore.
+ */
+bool Socket::accept(Socket& client)
+{
+    Handle handle = ::accept(m_handle, nullptr, nullptr);
+    if (handle == INVALID_HANDLE)
+        return false;
+
+    client.close();
+    client.m_handle = handle;
+    configureConnection(handle);
+    return true;
+}
+
+/**
+ * Connects to a listening socket.
+ *
+ * \param host The host to connect to.
+ * \param port The port to connect to.
+ * \return Returns true if the operation was successful.
+ */
+bool Socket::connect(const std::string& host, uint16_t port)
+{
+    close();
+
+    sockaddr_in address{};
+    if (!resolve(host, port, address))
+        return false;
+
+    m_handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_handle == INVALID_HANDLE)
+        return false;
+
+    if (::connect(m_handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close();
+        return false;
+    }
+
+    configureConnection(m_handle);
+    return true;
+}
+
+/**
+ * Reads the next line. Only one thread may read from a socket at a time.
+ *
+ * \param line Receives the line without the terminating '\n'.
+ * \return Returns true if a line was read. False means, that the connection was closed.
+ */
+bool Socket::readLine(std::string& line)
+{
+    while (true)
+    {
+        size_t end = m_readBuffer.find('\n');
+        if (end != std::string::npos)
+        {
+            line = m_readBuffer.substr(0, end);
+            m_readBuffer.erase(0, end + 1);
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            return true;
+        }
+
+        char buffer[4096];
+        int received = recv(m_handle, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            return false;
+
+        m_readBuffer.append(buffer, received);
+    }
+}
+
+/**
+ * Writes a line. Several threads may write to the same socket, every line is sent as a whole.
+ *
+ * \param line The line to send without a terminating '\n'.
+ * \return Returns true if the operation was successful.
+ */
+bool Socket::writeLine(const std::string& line)
+{
+    std::string message = line + "\n";
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+
+    size_t sent = 0;
+    while (sent < message.size())
+    {
+        // A peer that closed the connection (EPIPE) is treated like any other closed connection.
+        int result = send(m_handle, message.data() + sent, static_cast<int>(message.size() - sent), SEND_FLAGS);
+        if (result <= 0)
+            return false;
+
+        sent += result;
+    }
+
+    return true;
+}
+
+/**
+ * Stops all reads and writes, but keeps the socket open. A thread that is blocked in Socket::readLine or
+ * Socket::accept returns right away.
+ *
+ */
+void Socket::shutdown()
+{
+    if (m_handle == INVALID_HANDLE)
+        return;
+
+#ifdef _WIN32
+    ::shutdown(m_handle, SD_BOTH);
+#else
+    ::shutdown(m_handle, SHUT_RDWR);
+#endif
+}
+
+/**
+ * Closes the connection.
+ *
+ */
+void Socket::close()
+{
+    if (m_handle == INVALID_HANDLE)
+        return;
+
+    closeHandle(m_handle);
+    m_handle = INVALID_HANDLE;
+    m_readBuffer.clear();
+}
+
+/**
+ * Indicates if the socket is open.
+ *
+ * \return Returns true if the socket is open.
+ */
+bool Socket::isOpen()
+{
+    return m_handle != INVALID_HANDLE;
+}
+
+/**
+ * Gives info about the port the socket is bound to.
+ *
+ * \return Returns the local port. 0 if the socket is not open.
+ */
+uint16_t Socket::localPort()
+{
+    sockaddr_in address{};
+#ifdef _WIN32
+    int length = sizeof(address);
+#else
+    socklen_t length = sizeof(address);
+#endif
+    if (m_handle == INVALID_HANDLE || getsockname(m_handle, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+        return 0;
+
+    return ntohs(address.sin_port);
+}
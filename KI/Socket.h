@@ -0,0 +1,40 @@
+#ifndef SOCKET_H
+#define SOCKET_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Line based TCP connection. Every message is a single line of text terminated by '\n'.
+class Socket
+{
+public:
+    Socket();
+    ~Socket();
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    bool listen(const std::string& host, uint16_t port);
+    bool accept(Socket& client);
+    bool connect(const std::string& host, uint16_t port);
+    bool readLine(std::string& line);
+    bool writeLine(const std::string& line);
+    void shutdown();
+    void close();
+    bool isOpen();
+    uint16_t localPort();
+
+private:
+#ifdef _WIN32
+    using Handle = uintptr_t;
+#else
+    using Handle = int;
+#endif
+
+    Handle              m_handle;
+    std::string         m_readBuffer;
+    std::mutex          m_writeMutex;
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include <algorithm>
+
+#include "Solver.h"
+
+// Number of cells of the field.
+constexpr int SOLVER_CELLS = FIELD_WIDTH * FIELD_HEIGHT;
+
+/**
+ * Helper function to spread the packed keys over the whole table.
+ *
+ * \param key The key to hash.
+ * \return Returns the hashed key.
+ */
+static uint64_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * Public constructor.
+ *
+ * \param tableSize The number of entries of the table. It is rounded down to a power of two.
+ */
+Solver::Solver(size_t tableSize)
+{
+    size_t roundedSize = 1;
+    while (roundedSize * 2 <= tableSize)
+        roundedSize *= 2;
+
+    m_table.reset(new uint64_t[roundedSize]());
+    m_tableMask = roundedSize - 1;
+}
+
+/**
+ * Calculates the exact score of a position, see SOLVER_MIN_SCORE.
+ *
+ * \param board The position. The game must not be over.
+ * \return Returns the score for the player to move.
+ */
+int Solver::solve(const Bitboard& board)
+{
+    if (board.winningPositions() & board.possibleMoves())
+        return (SOLVER_CELLS + 1 - board.moveCount()) / 2;
+
+    // Narrow the possible range with null window searches. Scores close to 0 are tried first, because they are cheaper
+    // to prove.
+    int min = -(SOLVER_CELLS - board.moveCount()) / 2;
+    int max = (SOLVER_CELLS + 1 - board.moveCount()) / 2;
+    while (min < max)
+    {
+        int medium = min + (max - min) / 2;
+        if (medium <= 0 && min / 2 < medium)
+            medium = min / 2;
+        else if (medium >= 0 && max / 2 > medium)
+            medium = max / 2;
+
+        int result = negamax(board, medium, medium + 1);
+        if (result <= medium)
+            max = result;
+        else
+            min = result;
+    }
+
+    return min;
+}
+
+/**
+ * Calculates the exact score of every move of a position.
+ *
+ * \param board The position. The game must not be over.
+ * \param scores Receives the score of every column for the player that makes the move. SOLVER_INVALID_SCORE for full
+ * columns.
+ */
+void Solver::analyze(const Bitboard& board, int scores[FIELD_WIDTH])
+{
+    for (int column = 0; column < FIELD_WIDTH; column++)
+    {
+        if (!board.canPlay(column))
+        {
+            scores[column] = SOLVER_INVALID_SCORE;
+            continue;
+        }
+
+        if (board.isWinningMove(column))
+        {
+            scores[column] = (SOLVER_CELLS + 1 - board.moveCount()) / 2;
+            continue;
+        }
+
+        Bitboard child = board;
+        child.play(column);
+        scores[column] = child.isFull() ? 0 : -solve(child);
+    }
+}
+
+/**
+ * Gives info about the work of the solver.
+ *
+ * \return Returns the number of positions searched since the last call of Solver::clear.
+ */
+uint64_t Solver::getNodeCount()
+{
+    return m_nodeCount;
+}
+
+/**
+ * Removes all entries of the table and resets the node count.
+ *
+ */
+void Solver::clear()
+{
+    std::fill(m_table.get(), m_table.get() + m_tableMask + 1, 0);
+    m_nodeCount = 0;
+}
+
+/**
+ * Negamax function that works recursively. The player to move must not be able to win with its next move.
+ *
+ * \param board The position.
+ * \param alpha Alpha value for Alpha-Beta pruning.
+ * \param beta Beta value for Alpha-Beta pruning.
+ * \return Returns the exact score if it is between alpha and beta. Otherwise an upper bound that is not greater than
+ * alpha, or a lower bound that is not less than beta.
+ */
+int Solver::negamax(const Bitboard& board, int alpha, int beta)
+{
+    m_nodeCount++;
+
+    uint64_t nonLosingMoves = board.possibleNonLosingMoves();
+    if (nonLosingMoves == 0)
+        return -(SOLVER_CELLS - board.moveCount()) / 2;
+
+    if (board.moveCount() >= SOLVER_CELLS - 2)
+        return 0;
+
+    // The opponent can not win with its next move, so the score can not be lower than this.
+    int min = -(SOLVER_CELLS - 2 - board.moveCount()) / 2;
+    if (alpha < min)
+    {
+        alpha = min;
+        if (alpha >= beta)
+            return alpha;
+    }
+
+    // The player to move can not win with its next move either.
+    int max = (SOLVER_CELLS - 1 - board.moveCount()) / 2;
+
+    // Entries: |key 56 bit|bound 8 bit|. Upper bounds are stored from 1 up, lower bounds above them.
+    uint64_t key = board.key();
+    uint64_t& entry = m_table[hashKey(key) & m_tableMask];
+    if ((entry >> 8) == key)
+    {
+        int stored = (int)(entry & 0xFF);
+        if (stored > SOLVER_MAX_SCORE - SOLVER_MIN_SCORE + 1)
+            min = stored + 2 * SOLVER_MIN_SCORE - SOLVER_MAX_SCORE - 2;
+        else
+            max = stored + SOLVER_MIN_SCORE - 1;
+    }
+
+    if (alpha < min)
+    {
+        alpha = min;
+        if (alpha >= beta)
+            return alpha;
+    }
+    if (beta > max)
+    {
+        beta = max;
+        if (alpha >= beta)
+            return beta;
+    }
+
+    // Try the moves that create the most threats first, the center columns first if there is a tie.
+    static const int columnOrder[FIELD_WIDTH] = { 3, 2, 4, 1, 5, 0, 6 };
+    Bitboard children[FIELD_WIDTH];
+    int threats[FIELD_WIDTH];
+    int childCount = 0;
+    for (int column : columnOrder)
+    {
+        if (!(nonLosingMoves & Bitboard::columnMask(column)))
+            continue;
+
+        Bitboard child = board;
+        child.play(column);
+        int childThreats = Bitboard::popCount(child.opponentWinningPositions());
+
+        int position = childCount++;
+        for (; position > 0 && threats[position - 1] < childThreats; position--)
+        {
+            children[position] = children[position - 1];
+            threats[position] = threats[position - 1];
+        }
+        children[position] = child;
+        threats[position] = childThreats;
+    }
+
+    for (int childNr = 0; childNr < childCount; childNr++)
+    {
+        int score = -negamax(children[childNr], -beta, -alpha);
+        if (score >= beta)
+        {
+            entry = (key << 8) | (uint64_t)(score + SOLVER_MAX_SCORE - 2 * SOLVER_MIN_SCORE + 2);
+            return score;
+        }
+
+        alpha = std::max(alpha, score);
+    }
+
+    entry = (key << 8) | (uint64_t)(alpha - SOLVER_MIN_SCORE + 1);
+    return alpha;
+}
@@ -0,0 +1,38 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Bitboard.h"
+
+// Scores of the exact solver, seen from the player to move. A win with the last stone of the winner scores 1, every
+// stone the winner has left after winning adds 1. Losses are negative in the same way, a draw is 0.
+constexpr int SOLVER_MIN_SCORE = -(FIELD_WIDTH * FIELD_HEIGHT) / 2 + 3;
+constexpr int SOLVER_MAX_SCORE = (FIELD_WIDTH * FIELD_HEIGHT + 1) / 2 - 3;
+// Score of a column that is full.
+constexpr int SOLVER_INVALID_SCORE = -1000;
+// Default number of entries of the solver's table. Every entry takes 8 bytes.
+constexpr size_t SOLVER_DEFAULT_TABLE_SIZE = size_t(1) << 23;
+
+// Exact solver that searches until the end of the game. It uses a negamax search with alpha-beta pruning on a
+// Bitboard, narrows the score with null window searches and remembers bounds in a table.
+class Solver
+{
+public:
+    Solver(size_t tableSize = SOLVER_DEFAULT_TABLE_SIZE);
+
+    int solve(const Bitboard& board);
+    void analyze(const Bitboard& board, int scores[FIELD_WIDTH]);
+    uint64_t getNodeCount();
+    void clear();
+
+private:
+    int negamax(const Bitboard& board, int alpha, int beta);
+
+    std::unique_ptr<uint64_t[]>     m_table;
+    size_t                          m_tableMask;
+    uint64_t                        m_nodeCount     = 0;
+};
+
+#endif
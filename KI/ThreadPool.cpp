@@ -0,0 +1,101 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+/**
+ * Public constructor. Starts all worker threads.
+ *
+ * \param threadCount The number of worker threads. 0 uses one thread per core.
+ * \param maxQueuedTasks The maximum number of tasks that can wait for a free worker.
+ */
+ThreadPool::ThreadPool(size_t threadCount, size_t maxQueuedTasks) : m_maxQueuedTasks(maxQueuedTasks)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t index = 0; index < threadCount; index++)
+    {
+        m_threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+/**
+ * Destructor. Finishes all queued tasks and joins the worker threads.
+ *
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Queues a task for the next free worker.
+ *
+ * \param task The task to run.
+ * \return Returns true if the task was queued. False means, that the queue is full and the task was rejected.
+ */
+bool ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping || m_tasks.size() >= m_maxQueuedTasks)
+            return false;
+
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+    return true;
+}
+
+/**
+ * Gives info about the number of worker threads.
+ *
+ * \return Returns the number of worker threads.
+ */
+size_t ThreadPool::threadCount()
+{
+    return m_threads.size();
+}
+
+/**
+ * Gives info about the number of tasks waiting for a free worker.
+ *
+ * \return Returns the number of queued tasks.
+ */
+size_t ThreadPool::queuedTasks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+/**
+ * Loop of every worker thread. Runs queued tasks until the pool is destroyed.
+ *
+ */
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    ThreadPool(size_t threadCount, size_t maxQueuedTasks);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    bool submit(std::function<void()> task);
+    size_t threadCount();
+    size_t queuedTasks();
+
+private:
+    void work();
+
+    std::vector<std::thread>            m_threads;
+    std::deque<std::function<void()>>   m_tasks;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_condition;
+    size_t                              m_maxQueuedTasks;
+    bool                                m_stopping          = false;
+};
+
+#endif
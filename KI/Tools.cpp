@@ -0,0 +1,679 @@
+#include <climits>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Algorithm.h"
+#include "AnalysisWorker.h"
+#include "Benchmark.h"
+#include "Bitboard.h"
+#include "Coordinator.h"
+#include "Engine.h"
+#include "GameServer.h"
+#include "LoadGenerator.h"
+#include "PerfCounters.h"
+#include "ProofNumberSearch.h"
+#include "SelfPlayGenerator.h"
+#include "Tools.h"
+#include "Tournament.h"
+#include "Trace.h"
+
+using Options = std::map<std::string, std::string>;
+
+/**
+ * Helper function to read "--name value" pairs from the command line.
+ *
+ * \param argc The number of arguments.
+ * \param argv The arguments.
+ * \param first The index of the first option.
+ * \param options Receives the options without the leading "--".
+ * \return Returns true if all arguments could be read.
+ */
+static bool parseOptions(int argc, char* argv[], int first, Options& options)
+{
+    for (int index = first; index < argc; index += 2)
+    {
+        std::string name = argv[index];
+        if (name.size() < 3 || name.compare(0, 2, "--") != 0 || index + 1 >= argc)
+            return false;
+
+        options[name.substr(2)] = argv[index + 1];
+    }
+
+    return true;
+}
+
+/**
+ * Helper function to read a numeric option.
+ *
+ * \param options The parsed options.
+ * \param name The name of the option.
+ * \param defaultValue The value to use if the option is missing.
+ * \return Returns the value of the option.
+ */
+static long long getOption(const Options& options, const std::string& name, long long defaultValue)
+{
+    auto option = options.find(name);
+    return option == options.end() ? defaultValue : std::stoll(option->second);
+}
+
+/**
+ * Helper function to read a text option.
+ *
+ * \param options The parsed options.
+ * \param name The name of the option.
+ * \param defaultValue The value to use if the option is missing.
+ * \return Returns the value of the option.
+ */
+static std::string getOption(const Options& options, const std::string& name, const std::string& defaultValue)
+{
+    auto option = options.find(name);
+    return option == options.end() ? defaultValue : option->second;
+}
+
+/**
+ * Helper function to read the selective depth control of the Algorithm.
+ *
+ * \param options The parsed options. "--extensions" limits the extensions per line, "--reductions" sets the plies
+ * late moves are reduced by. 0 disables them.
+ * \return Returns the configuration.
+ */
+static SelectiveSearch getSelectiveSearch(const Options& options)
+{
+    SelectiveSearch selectiveSearch;
+    selectiveSearch.maxExtensions = (int)getOption(options, "extensions", selectiveSearch.maxExtensions);
+    int reduction = (int)getOption(options, "reductions",
+        selectiveSearch.lateMoveReductions ? selectiveSearch.reduction : 0);
+    selectiveSearch.lateMoveReductions = reduction > 0;
+    if (reduction > 0)
+        selectiveSearch.reduction = reduction;
+    return selectiveSearch;
+}
+
+/**
+ * Runs the GameServer until the process is terminated.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runServer(const Options& options)
+{
+    GameServer::Options serverOptions;
+    serverOptions.host = getOption(options, "host", serverOptions.host);
+    serverOptions.port = (uint16_t)getOption(options, "port", serverOptions.port);
+    serverOptions.engine = getOption(options, "engine", serverOptions.engine);
+    serverOptions.threads = (size_t)getOption(options, "threads", (long long)serverOptions.threads);
+    serverOptions.maxSessions = (size_t)getOption(options, "sessions", (long long)serverOptions.maxSessions);
+    serverOptions.maxQueuedSearches = (size_t)getOption(options, "queue", (long long)serverOptions.maxQueuedSearches);
+    serverOptions.defaultTimeBudgetMs = (int)getOption(options, "budget", serverOptions.defaultTimeBudgetMs);
+    serverOptions.memoryBudgetMb = (size_t)getOption(options, "memory", (long long)serverOptions.memoryBudgetMb);
+
+    GameServer server(serverOptions);
+    if (!server.start())
+    {
+        std::cerr << "Could not listen on " << serverOptions.host << ":" << serverOptions.port << std::endl;
+        return 1;
+    }
+
+    std::cout << "Listening on " << serverOptions.host << ":" << server.port() << std::endl;
+    server.run();
+    return 0;
+}
+
+/**
+ * Runs the LoadGenerator against a running server and prints its report.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runLoadGenerator(const Options& options)
+{
+    LoadGenerator::Options loadOptions;
+    loadOptions.host = getOption(options, "host", loadOptions.host);
+    loadOptions.port = (uint16_t)getOption(options, "port", loadOptions.port);
+    loadOptions.connections = (int)getOption(options, "connections", loadOptions.connections);
+    loadOptions.sessionsPerConnection = (int)getOption(options, "sessions", loadOptions.sessionsPerConnection);
+    loadOptions.timeBudgetMs = (int)getOption(options, "budget", loadOptions.timeBudgetMs);
+    loadOptions.durationSeconds = (int)getOption(options, "seconds", loadOptions.durationSeconds);
+    loadOptions.seed = (uint32_t)getOption(options, "seed", loadOptions.seed);
+
+    LoadGenerator generator(loadOptions);
+    LoadGenerator::Report report;
+    bool success = generator.run(report);
+    LoadGenerator::printReport(report);
+    return success ? 0 : 1;
+}
+
+/**
+ * Plays two engines against each other and prints the results.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runTournament(const Options& options)
+{
+    Tournament::Options tournamentOptions;
+    tournamentOptions.firstEngine = getOption(options, "first", tournamentOptions.firstEngine);
+    tournamentOptions.secondEngine = getOption(options, "second", tournamentOptions.secondEngine);
+    tournamentOptions.games = (int)getOption(options, "games", tournamentOptions.games);
+    tournamentOptions.timeBudgetMs = (int)getOption(options, "budget", tournamentOptions.timeBudgetMs);
+    tournamentOptions.randomMoves = (int)getOption(options, "random", tournamentOptions.randomMoves);
+    tournamentOptions.memoryBudgetMb = (size_t)getOption(options, "memory",
+        (long long)tournamentOptions.memoryBudgetMb);
+    tournamentOptions.threads = (int)getOption(options, "threads", tournamentOptions.threads);
+    tournamentOptions.seed = (uint32_t)getOption(options, "seed", tournamentOptions.seed);
+
+    Tournament tournament(tournamentOptions);
+    Tournament::Report report;
+    if (!tournament.run(report))
+    {
+        std::cerr << "Unknown engine" << std::endl;
+        return 1;
+    }
+
+    tournament.printReport(report);
+    return 0;
+}
+
+/**
+ * Runs the Benchmark and compares it with the baseline.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code. 1 means, that the benchmark could not run or a set regressed.
+ */
+static int runBenchmark(const Options& options)
+{
+    Benchmark::Options benchmarkOptions;
+    benchmarkOptions.directory = getOption(options, "sets", benchmarkOptions.directory);
+    benchmarkOptions.baseline = getOption(options, "baseline", benchmarkOptions.directory + "/baseline.txt");
+    benchmarkOptions.nodeTolerancePercent = (int)getOption(options, "tolerance", benchmarkOptions.nodeTolerancePercent);
+    benchmarkOptions.timeTolerancePercent = (int)getOption(options, "time-tolerance",
+        benchmarkOptions.timeTolerancePercent);
+    benchmarkOptions.timeBudgetMs = (int)getOption(options, "budget", benchmarkOptions.timeBudgetMs);
+    benchmarkOptions.selectiveSearch = getSelectiveSearch(options);
+
+    Benchmark benchmark(benchmarkOptions);
+    std::vector<Benchmark::SetResult> results;
+    if (!benchmark.run(results))
+    {
+        std::cerr << "Could not read the sets in " << benchmarkOptions.directory << std::endl;
+        return 1;
+    }
+    benchmark.printReport(results);
+
+    if (getOption(options, "write", 0) != 0)
+    {
+        if (!benchmark.writeBaseline(results))
+        {
+            std::cerr << "Could not write " << benchmarkOptions.baseline << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    std::vector<std::string> regressions;
+    if (!benchmark.compare(results, regressions))
+    {
+        std::cerr << "Could not read " << benchmarkOptions.baseline << std::endl;
+        return 1;
+    }
+
+    for (const std::string& regression : regressions)
+        std::cerr << "Regression in " << regression << std::endl;
+
+    return regressions.empty() ? 0 : 1;
+}
+
+/**
+ * Creates the sets of the Benchmark.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runBenchmarkSets(const Options& options)
+{
+    Benchmark::Options benchmarkOptions;
+    benchmarkOptions.directory = getOption(options, "sets", benchmarkOptions.directory);
+
+    Benchmark benchmark(benchmarkOptions);
+    if (!benchmark.generate((int)getOption(options, "positions", 20), (uint32_t)getOption(options, "seed", 1)))
+    {
+        std::cerr << "Could not write the sets to " << benchmarkOptions.directory << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Analyses a set of positions with worker processes and writes the results as a record file.
+ *
+ * \param options The options of the tool.
+ * \param executable The path of this program, which is started for the local workers.
+ * \return Returns the exit code. 1 means, that the coordinator could not run or some positions were not analysed.
+ */
+static int runCoordinator(const Options& options, const std::string& executable)
+{
+    std::vector<std::string> positions;
+    if (options.count("input"))
+    {
+        if (!Coordinator::readPositions(getOption(options, "input", std::string()), positions))
+        {
+            std::cerr << "Could not read the positions" << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        Coordinator::expandFrontier((int)getOption(options, "frontier", 2), positions);
+    }
+
+    Coordinator::Options coordinatorOptions;
+    coordinatorOptions.host = getOption(options, "host", coordinatorOptions.host);
+    coordinatorOptions.port = (uint16_t)getOption(options, "port", coordinatorOptions.port);
+    coordinatorOptions.workers = (int)getOption(options, "workers", coordinatorOptions.workers);
+    coordinatorOptions.shardSize = (size_t)getOption(options, "shard", (long long)coordinatorOptions.shardSize);
+    coordinatorOptions.timeBudgetMs = (int)getOption(options, "budget", coordinatorOptions.timeBudgetMs);
+    coordinatorOptions.memoryBudgetMb = (size_t)getOption(options, "memory",
+        (long long)coordinatorOptions.memoryBudgetMb);
+    coordinatorOptions.maxAttempts = (int)getOption(options, "attempts", coordinatorOptions.maxAttempts);
+    if (getOption(options, "spawn", 1) != 0)
+        coordinatorOptions.executable = executable;
+    if (options.count("worker-exit-after"))
+        coordinatorOptions.workerArguments = { "--exit-after", getOption(options, "worker-exit-after", std::string()) };
+
+    Coordinator coordinator(coordinatorOptions);
+    std::vector<PositionRecord> results;
+    Coordinator::Report report;
+    if (!coordinator.run(positions, results, report))
+    {
+        std::cerr << "Could not start the coordinator" << std::endl;
+        return 1;
+    }
+    Coordinator::printReport(report);
+
+    std::string output = getOption(options, "output", std::string("analysis.c4rb"));
+    RecordWriter writer;
+    if (!writer.open(output, RecordType::Position))
+    {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+    for (const PositionRecord& record : results)
+        writer.write(record);
+    writer.close();
+
+    return report.failedShards == 0 ? 0 : 1;
+}
+
+/**
+ * Analyses shards for a coordinator until it has no more work.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runWorker(const Options& options)
+{
+    AnalysisWorker::Options workerOptions;
+    workerOptions.host = getOption(options, "host", workerOptions.host);
+    workerOptions.port = (uint16_t)getOption(options, "port", workerOptions.port);
+    workerOptions.memoryBudgetMb = (size_t)getOption(options, "memory", (long long)workerOptions.memoryBudgetMb);
+    workerOptions.exitAfterShards = (int)getOption(options, "exit-after", workerOptions.exitAfterShards);
+
+    AnalysisWorker worker(workerOptions);
+    return worker.run() ? 0 : 1;
+}
+
+/**
+ * Helper function to read the position of a tool. The moves are given like "4453". The algorithm is always the player
+ * to move, so the player that made the first move follows from the number of moves, like in the benchmark sets.
+ *
+ * \param options The options of the tool.
+ * \param field Receives the position.
+ * \return Returns true if the moves are valid and the game is not over.
+ */
+static bool getPosition(const Options& options, Field& field)
+{
+    std::string moves = getOption(options, "moves", std::string());
+    Field::Player firstPlayer = moves.size() % 2 == 0 ? Field::Player::Algorithm : Field::Player::Human;
+
+    field = Field();
+    return field.placeStones(moves, firstPlayer) && !field.isGameOver();
+}
+
+/**
+ * Helper function to print the work of the selective depth control of the last search.
+ *
+ * \param algorithm The algorithm that ran the search.
+ */
+static void printSelectiveStatistics(Algorithm& algorithm)
+{
+    SelectiveStatistics statistics = algorithm.getSelectiveStatistics();
+    std::cout << statistics.extensions << " extensions, " << statistics.reductions << " reductions, "
+        << statistics.reSearches << " re-searches, " << statistics.lostMoves << " lost moves" << std::endl;
+}
+
+/**
+ * Prints the values and principal variations of the moves of a position.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runAnalysis(const Options& options)
+{
+    Field field;
+    if (!getPosition(options, field))
+    {
+        std::cerr << "Invalid moves" << std::endl;
+        return 1;
+    }
+
+    Algorithm algorithm;
+    algorithm.setTranspositionTable(std::make_shared<TranspositionTable>());
+    algorithm.setMemoryBudget((size_t)getOption(options, "memory", (long long)ENGINE_DEFAULT_MEMORY_BUDGET_MB));
+    algorithm.setSelectiveSearch(getSelectiveSearch(options));
+    std::vector<MoveAnalysis> analysis = algorithm.analyze(field, (int)getOption(options, "top", 0),
+        (int)getOption(options, "budget", 0));
+
+    for (const MoveAnalysis& move : analysis)
+    {
+        std::cout << "  " << move.column << ": " << (move.bound == TranspositionTable::Bound::Upper ? "<= " : "");
+        if (move.value == INT_MAX)
+            std::cout << "win";
+        else if (move.value == INT_MIN)
+            std::cout << "loss";
+        else
+            std::cout << move.value;
+
+        std::cout << "   pv";
+        for (int column : move.principalVariation)
+            std::cout << ' ' << column;
+        std::cout << std::endl;
+    }
+
+    printSelectiveStatistics(algorithm);
+    return 0;
+}
+
+/**
+ * Answers whether the player to move can force a win or will lose, with proof-number search.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runProof(const Options& options)
+{
+    Field field;
+    if (!getPosition(options, field))
+    {
+        std::cerr << "Invalid moves" << std::endl;
+        return 1;
+    }
+
+    // The human starts, so the number of moves tells who is to move.
+    std::string moves = getOption(options, "moves", std::string());
+    Bitboard board(field, moves.size() % 2 == 0 ? Field::Player::Human : Field::Player::Algorithm);
+    ProofNumberSearch search;
+    std::vector<int> line;
+    ProofNumberSearch::Result result = search.prove(board,
+        (uint64_t)getOption(options, "nodes", (long long)DEFAULT_PROOF_NODE_BUDGET * 50), line);
+
+    const char* names[] = { "unknown", "win", "loss", "draw", "no win" };
+    std::cout << names[(int)result] << " for the player to move, " << search.getNodeCount() << " nodes";
+    if (!line.empty())
+    {
+        std::cout << ", line";
+        for (int column : line)
+            std::cout << ' ' << column + 1;
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
+
+/**
+ * Runs one search on a position and writes its timeline as Chrome trace JSON. Needs a build with KI_TRACE.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runTrace(const Options& options)
+{
+    if (!Trace::isEnabled())
+    {
+        std::cerr << "Tracing is not compiled in, build with KI_TRACE defined" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<Engine> engine = Engine::create(getOption(options, "engine", std::string("minimax")));
+    if (!engine)
+    {
+        std::cerr << "Unknown engine" << std::endl;
+        return 1;
+    }
+    engine->setMemoryBudget((size_t)getOption(options, "memory", (long long)ENGINE_DEFAULT_MEMORY_BUDGET_MB));
+
+    Field field;
+    if (!getPosition(options, field))
+    {
+        std::cerr << "Invalid moves" << std::endl;
+        return 1;
+    }
+
+    Trace::clear();
+    int move = engine->getNextMove(field, (int)getOption(options, "budget", 0));
+
+    std::string output = getOption(options, "output", std::string("trace.json"));
+    if (!Trace::writeChromeJson(output))
+    {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Move " << move << ", trace written to " << output << std::endl;
+    return 0;
+}
+
+/**
+ * Runs one search on a position and prints the hardware counters of its regions, for the whole search and per
+ * searched node. The proof-number search is divided by its own nodes, the regions of minimax by the minimax nodes.
+ * Needs a build with KI_PERF_COUNTERS.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runPerfCounters(const Options& options)
+{
+    if (!PerfCounters::isEnabled())
+    {
+        std::cerr << "Performance counters are not compiled in, build with KI_PERF_COUNTERS defined" << std::endl;
+        return 1;
+    }
+
+    Field field;
+    if (!getPosition(options, field))
+    {
+        std::cerr << "Invalid moves" << std::endl;
+        return 1;
+    }
+
+    Algorithm algorithm;
+    algorithm.setTranspositionTable(std::make_shared<TranspositionTable>());
+    algorithm.setMemoryBudget((size_t)getOption(options, "memory", (long long)ENGINE_DEFAULT_MEMORY_BUDGET_MB));
+    algorithm.setProofNodeBudget((uint64_t)getOption(options, "proof-nodes", (long long)DEFAULT_PROOF_NODE_BUDGET));
+    algorithm.setSelectiveSearch(getSelectiveSearch(options));
+
+    PerfCounters::reset();
+    int move = algorithm.getNextMove(field, (int)getOption(options, "budget", 0));
+    PerfCounters::Sample sample = PerfCounters::read();
+    uint64_t proofNodes = algorithm.getProofNodes();
+    uint64_t minimaxNodes = algorithm.getSearchedNodes() - proofNodes;
+
+    std::cout << "Move " << move << ", " << minimaxNodes << " minimax nodes, " << proofNodes << " proof nodes, "
+        << std::fixed << std::setprecision(1) << algorithm.getEvaluationStatistics().getHitRate() * 100
+        << "% evaluation cache hits" << std::endl;
+    printSelectiveStatistics(algorithm);
+    if (!PerfCounters::unavailableReason().empty())
+        std::cout << "Missing counters, " << PerfCounters::unavailableReason() << std::endl;
+    if (sample.multiplexed)
+        std::cout << "The counters were multiplexed, their values are too low" << std::endl;
+
+    // One row per region and a total, each with the whole search and the share of one node.
+    std::cout << std::left << std::setw(20) << "region" << std::right << std::setw(12) << "calls" << std::setw(12)
+        << "ms";
+    for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+        std::cout << std::setw(16) << PerfCounters::name((PerfCounters::Counter)counterNr);
+    std::cout << std::setw(8) << "IPC" << std::endl;
+
+    PerfCounters::Sample total;
+    for (int regionNr = 0; regionNr <= PerfCounters::REGION_COUNT; regionNr++)
+    {
+        bool isTotal = regionNr == PerfCounters::REGION_COUNT;
+        const PerfCounters::Sample& source = isTotal ? total : sample;
+        int index = isTotal ? 0 : regionNr;
+        if (!isTotal)
+        {
+            total.calls[0] += sample.calls[regionNr];
+            total.nanoseconds[0] += sample.nanoseconds[regionNr];
+            for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+                total.values[0][counterNr] += sample.values[regionNr][counterNr];
+        }
+
+        uint64_t nodes = isTotal ? algorithm.getSearchedNodes()
+            : regionNr == (int)PerfCounters::Region::ProofNumberSearch ? proofNodes : minimaxNodes;
+        for (double divisor : { 1.0, (double)std::max<uint64_t>(nodes, 1) })
+        {
+            std::string name = isTotal ? "total" : PerfCounters::name((PerfCounters::Region)regionNr);
+            std::cout << std::left << std::setw(20) << (divisor == 1.0 ? name : "  per node") << std::right
+                << std::fixed << std::setprecision(divisor == 1.0 ? 0 : 2) << std::setw(12)
+                << source.calls[index] / divisor << std::setprecision(divisor == 1.0 ? 3 : 6) << std::setw(12)
+                << source.nanoseconds[index] / 1e6 / divisor << std::setprecision(divisor == 1.0 ? 0 : 2);
+            for (int counterNr = 0; counterNr < PerfCounters::COUNTER_COUNT; counterNr++)
+            {
+                if (PerfCounters::isAvailable((PerfCounters::Counter)counterNr))
+                    std::cout << std::setw(16) << source.values[index][counterNr] / divisor;
+                else
+                    std::cout << std::setw(16) << "n/a";
+            }
+
+            uint64_t cycles = source.values[index][(int)PerfCounters::Counter::Cycles];
+            uint64_t instructions = source.values[index][(int)PerfCounters::Counter::Instructions];
+            if (divisor == 1.0 && cycles > 0)
+                std::cout << std::setprecision(2) << std::setw(8) << (double)instructions / cycles;
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Generates training data with the SelfPlayGenerator and prints its report.
+ *
+ * \param options The options of the tool.
+ * \return Returns the exit code.
+ */
+static int runSelfPlay(const Options& options)
+{
+    SelfPlayGenerator::Options selfPlayOptions;
+    selfPlayOptions.threads = (size_t)getOption(options, "threads", (long long)selfPlayOptions.threads);
+    selfPlayOptions.positions = (uint64_t)getOption(options, "positions", (long long)selfPlayOptions.positions);
+    selfPlayOptions.samplesPerGame = (int)getOption(options, "samples", selfPlayOptions.samplesPerGame);
+    selfPlayOptions.minStones = (int)getOption(options, "min-stones", selfPlayOptions.minStones);
+    selfPlayOptions.timeBudgetMs = (int)getOption(options, "budget", selfPlayOptions.timeBudgetMs);
+    selfPlayOptions.memoryBudgetMb = (size_t)getOption(options, "memory", (long long)selfPlayOptions.memoryBudgetMb);
+    selfPlayOptions.output = getOption(options, "output", selfPlayOptions.output);
+    selfPlayOptions.shards = (int)getOption(options, "shards", selfPlayOptions.shards);
+    selfPlayOptions.append = getOption(options, "append", 0) != 0;
+    selfPlayOptions.seed = (uint32_t)getOption(options, "seed", selfPlayOptions.seed);
+    selfPlayOptions.progressSeconds = (int)getOption(options, "progress", selfPlayOptions.progressSeconds);
+
+    std::string label = getOption(options, "label", std::string("solver"));
+    if (label == "search")
+    {
+        selfPlayOptions.label = SelfPlayGenerator::Label::Search;
+    }
+    else if (label != "solver")
+    {
+        std::cerr << "Unknown label: " << label << std::endl;
+        return 1;
+    }
+
+    SelfPlayGenerator generator(selfPlayOptions);
+    SelfPlayGenerator::Report report;
+    bool success = generator.run(report);
+    SelfPlayGenerator::printReport(report);
+    if (!success)
+        std::cerr << "Could not write " << selfPlayOptions.output << std::endl;
+    return success ? 0 : 1;
+}
+
+/**
+ * Runs the tool named by the first argument.
+ *
+ * \param argc The number of arguments.
+ * \param argv The arguments.
+ * \return Returns the exit code of the tool.
+ */
+int runTool(int argc, char* argv[])
+{
+    std::string tool = argc > 1 ? argv[1] : "";
+    Options options;
+    bool validOptions = parseOptions(argc, argv, 2, options);
+
+    try
+    {
+        if (validOptions && tool == "server")
+            return runServer(options);
+        else if (validOptions && tool == "loadgen")
+            return runLoadGenerator(options);
+        else if (validOptions && tool == "tournament")
+            return runTournament(options);
+        else if (validOptions && tool == "trace")
+            return runTrace(options);
+        else if (validOptions && tool == "perf")
+            return runPerfCounters(options);
+        else if (validOptions && tool == "analyze")
+            return runAnalysis(options);
+        else if (validOptions && tool == "prove")
+            return runProof(options);
+        else if (validOptions && tool == "coordinator")
+            return runCoordinator(options, argv[0]);
+        else if (validOptions && tool == "worker")
+            return runWorker(options);
+        else if (validOptions && tool == "selfplay")
+            return runSelfPlay(options);
+        else if (validOptions && tool == "benchmark")
+            return runBenchmark(options);
+        else if (validOptions && tool == "benchmark-sets")
+            return runBenchmarkSets(options);
+    }
+    catch (const std::exception& e)
+    {
+        // std::stoll throws if an option is not a number.
+        std::cerr << "Invalid option: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Usage: connect_4 [<tool> [--option value]...]" << std::endl
+        << "  server       --host --port --engine --threads --sessions --queue --budget --memory" << std::endl
+        << "  loadgen      --host --port --connections --sessions --budget --seconds --seed" << std::endl
+        << "  tournament   --first --second --games --budget --random --memory --threads --seed" << std::endl
+        << "  trace        --engine --moves --budget --memory --output" << std::endl
+        << "  perf         --moves --budget --memory --proof-nodes --extensions --reductions" << std::endl
+        << "  analyze      --moves --top --budget --memory --extensions --reductions" << std::endl
+        << "  prove        --moves --nodes" << std::endl
+        << "  coordinator  --input | --frontier, --output --workers --shard --budget --memory --host --port --attempts"
+        << " --spawn --worker-exit-after" << std::endl
+        << "  worker       --host --port --memory --exit-after" << std::endl
+        << "  selfplay     --positions --threads --samples --label solver|search --min-stones --budget --memory"
+        << " --output --shards --append --seed --progress" << std::endl
+        << "  benchmark    --sets --baseline --tolerance --time-tolerance --budget --extensions --reductions --write"
+        << std::endl
+        << "  benchmark-sets --sets --positions --seed" << std::endl
+        << "Engines: minimax, mcts" << std::endl;
+    return 1;
+}
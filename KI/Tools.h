@@ -0,0 +1,9 @@
+#ifndef TOOLS_H
+#define TOOLS_H
+
+// Command line tools that run instead of the console game if the program is started with arguments:
+//  connect_4 <tool> [--option value]...
+// Unknown tools print a list of all tools and their options.
+int runTool(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include "Engine.h"
+#include "Tournament.h"
+
+/**
+ * Public constructor.
+ *
+ * \param options The configuration of the tournament.
+ */
+Tournament::Tournament(const Options& options) : m_options(options)
+{
+}
+
+/**
+ * Plays all games of the tournament.
+ *
+ * \param report Receives the results.
+ * \return Returns true if the operation was successful. False means, that an engine name is unknown.
+ */
+bool Tournament::run(Report& report)
+{
+    report = Report();
+    std::unique_ptr<Engine> engines[2] = { Engine::create(m_options.firstEngine, m_options.threads),
+        Engine::create(m_options.secondEngine, m_options.threads) };
+    if (!engines[0] || !engines[1])
+        return false;
+
+    engines[0]->setMemoryBudget(m_options.memoryBudgetMb);
+    engines[1]->setMemoryBudget(m_options.memoryBudgetMb);
+
+    std::mt19937 random(m_options.seed);
+    for (int gameNr = 0; gameNr < m_options.games; gameNr++)
+    {
+        // Every engine plays as Field::Player::Algorithm, so each one gets its own field with swapped colors.
+        Field fields[2];
+        int nextEngine = gameNr % 2;
+        int moveNr = 0;
+
+        while (!fields[0].isGameOver())
+        {
+            int column;
+            if (moveNr < m_options.randomMoves)
+            {
+                do
+                {
+                    column = (int)(random() % fields[0].width()) + 1;
+                } while (!fields[0].isMovePossible(column));
+            }
+            else
+            {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                column = engines[nextEngine]->getNextMove(fields[nextEngine], m_options.timeBudgetMs);
+                double moveMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+
+                (nextEngine == 0 ? report.firstMoveMs : report.secondMoveMs) += moveMs;
+                (nextEngine == 0 ? report.firstMoves : report.secondMoves)++;
+            }
+
+            if (!fields[nextEngine].placeStone(column, Field::Player::Algorithm)
+                || !fields[1 - nextEngine].placeStone(column, Field::Player::Human))
+                return false;
+
+            nextEngine = 1 - nextEngine;
+            moveNr++;
+        }
+
+        if (fields[0].isDraw())
+            report.draws++;
+        else if (fields[0].getWinner() == Field::Player::Algorithm)
+            report.firstWins++;
+        else
+            report.secondWins++;
+    }
+
+    return true;
+}
+
+/**
+ * Prints a report to the console.
+ *
+ * \param report The report to print.
+ */
+void Tournament::printReport(const Report& report)
+{
+    std::cout << m_options.firstEngine << " vs. " << m_options.secondEngine << " at " << m_options.timeBudgetMs
+        << " ms per move" << std::endl
+        << "  " << m_options.firstEngine << " won:  " << report.firstWins << std::endl
+        << "  " << m_options.secondEngine << " won:  " << report.secondWins << std::endl
+        << "  draws:  " << report.draws << std::endl
+        << "  mean move time " << m_options.firstEngine << ": "
+        << (report.firstMoves ? report.firstMoveMs / report.firstMoves : 0) << " ms" << std::endl
+        << "  mean move time " << m_options.secondEngine << ": "
+        << (report.secondMoves ? report.secondMoveMs / report.secondMoves : 0) << " ms" << std::endl;
+}
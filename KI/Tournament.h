@@ -0,0 +1,45 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <cstdint>
+#include <string>
+#include "Engine.h"
+
+// Plays two engines against each other with the same time budget per move. The engines take turns in making the first
+// move and every game starts with a few random moves, so the games differ even between deterministic engines.
+class Tournament
+{
+public:
+    struct Options
+    {
+        std::string     firstEngine         = "minimax";
+        std::string     secondEngine        = "mcts";
+        int             games               = 10;
+        int             timeBudgetMs        = 100;
+        int             randomMoves         = 2;
+        size_t          memoryBudgetMb      = ENGINE_DEFAULT_MEMORY_BUDGET_MB;  // Per engine
+        int             threads             = 1;    // Per engine that searches with several threads, 0 is one per core
+        uint32_t        seed                = 1;
+    };
+
+    struct Report
+    {
+        int             firstWins           = 0;
+        int             secondWins          = 0;
+        int             draws               = 0;
+        int             firstMoves          = 0;
+        int             secondMoves         = 0;
+        double          firstMoveMs         = 0;    // Total time of all moves
+        double          secondMoveMs        = 0;
+    };
+
+    Tournament(const Options& options);
+
+    bool run(Report& report);
+    void printReport(const Report& report);
+
+private:
+    Options m_options;
+};
+
+#endif
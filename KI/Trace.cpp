@@ -0,0 +1,231 @@
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Trace.h"
+
+namespace
+{
+    // Events of one thread. Only the owning thread writes, so recording does not need any locks.
+    struct ThreadBuffer
+    {
+        int                         threadIndex = 0;
+        std::vector<Trace::Event>   events;
+        std::atomic<uint64_t>       recorded{ 0 };
+        bool                        owned       = false;    // A running thread records into it, see Registry::mutex
+    };
+
+    // All buffers ever created. A buffer is kept after its thread ended, so its events can still be written, and is
+    // handed to the next thread that starts to record. Threads that come and go (e.g. of std::async) therefore share
+    // a few buffers instead of keeping one each, and their events continue in the same lane of the trace.
+    struct Registry
+    {
+        std::mutex                                  mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>>  buffers;
+    };
+
+    Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    // Gives the buffer of a thread back to the registry when the thread ends.
+    struct BufferOwner
+    {
+        std::shared_ptr<ThreadBuffer>   buffer;
+
+        ~BufferOwner()
+        {
+            if (!buffer)
+                return;
+
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            buffer->owned = false;
+        }
+    };
+
+    // Depth of the innermost TraceScope of the thread that has one.
+    thread_local int t_currentDepth = -1;
+}
+
+/**
+ * Helper function to get the buffer of the calling thread. On the first call it takes the buffer of a thread that
+ * ended, or creates a new one if there is none.
+ *
+ * \return Returns the buffer.
+ */
+static ThreadBuffer& threadBuffer()
+{
+    thread_local BufferOwner owner;
+    if (!owner.buffer)
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        for (const std::shared_ptr<ThreadBuffer>& buffer : registry().buffers)
+        {
+            if (!buffer->owned)
+            {
+                owner.buffer = buffer;
+                break;
+            }
+        }
+
+        if (!owner.buffer)
+        {
+            owner.buffer = std::make_shared<ThreadBuffer>();
+            owner.buffer->events.resize(TRACE_BUFFER_SIZE);
+            owner.buffer->threadIndex = (int)registry().buffers.size();
+            registry().buffers.push_back(owner.buffer);
+        }
+        owner.buffer->owned = true;
+    }
+
+    return *owner.buffer;
+}
+
+/**
+ * Helper function to write a string as JSON. Trace names are string literals, but they are escaped anyway.
+ *
+ * \param stream The stream to write to.
+ * \param text The string to write.
+ */
+static void writeJsonString(std::ofstream& stream, const char* text)
+{
+    stream << '"';
+    for (; *text; text++)
+    {
+        if (*text == '"' || *text == '\\')
+            stream << '\\';
+        stream << *text;
+    }
+    stream << '"';
+}
+
+/**
+ * Adds an event to the buffer of the calling thread.
+ *
+ * \param name The name of the event. Has to live until the trace is written, usually a string literal.
+ * \param startNs The start of the event, see Trace::now.
+ * \param durationNs The duration of the event in nanoseconds.
+ * \param depth The depth of the tree the event belongs to. -1 if it does not belong to a depth.
+ */
+void Trace::record(const char* name, int64_t startNs, int64_t durationNs, int depth)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t index = buffer.recorded.load(std::memory_order_relaxed);
+    buffer.events[index % TRACE_BUFFER_SIZE] = { name, startNs, durationNs, depth };
+    buffer.recorded.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * Gives the current time of the trace clock.
+ *
+ * \return Returns the nanoseconds since the first call.
+ */
+int64_t Trace::now()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+/**
+ * Writes all recorded events as Chrome trace JSON. Every thread becomes a process lane and every depth a thread lane.
+ * This should only be called while no search is running, otherwise the newest events may be incomplete.
+ *
+ * \param path The path of the file.
+ * \return Returns true if the operation was successful.
+ */
+bool Trace::writeChromeJson(const std::string& path)
+{
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream)
+        return false;
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffers = registry().buffers;
+    }
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : buffers)
+    {
+        uint64_t recorded = buffer->recorded.load(std::memory_order_acquire);
+        uint64_t begin = recorded > TRACE_BUFFER_SIZE ? recorded - TRACE_BUFFER_SIZE : 0;
+
+        stream << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << buffer->threadIndex
+            << ",\"args\":{\"name\":\"thread " << buffer->threadIndex << "\"}}";
+        first = false;
+
+        // Name the lanes of all depths that occur, sorted from the top of the tree downwards.
+        std::vector<bool> usedDepths;
+        for (uint64_t index = begin; index < recorded; index++)
+        {
+            size_t lane = (size_t)(buffer->events[index % TRACE_BUFFER_SIZE].depth + 1);
+            if (lane >= usedDepths.size())
+                usedDepths.resize(lane + 1, false);
+            usedDepths[lane] = true;
+        }
+        for (size_t lane = 0; lane < usedDepths.size(); lane++)
+        {
+            if (!usedDepths[lane])
+                continue;
+
+            stream << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << buffer->threadIndex << ",\"tid\":" << lane
+                << ",\"args\":{\"name\":\"" << (lane == 0 ? std::string("search") : "depth " + std::to_string(lane - 1))
+                << "\"}},\n{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":" << buffer->threadIndex
+                << ",\"tid\":" << lane << ",\"args\":{\"sort_index\":" << lane << "}}";
+        }
+
+        for (uint64_t index = begin; index < recorded; index++)
+        {
+            const Event& event = buffer->events[index % TRACE_BUFFER_SIZE];
+            stream << ",\n{\"ph\":\"X\",\"name\":";
+            writeJsonString(stream, event.name);
+            stream << ",\"pid\":" << buffer->threadIndex << ",\"tid\":" << event.depth + 1
+                << ",\"ts\":" << event.startNs / 1000 << '.' << (event.startNs % 1000) / 100
+                << ",\"dur\":" << event.durationNs / 1000 << '.' << (event.durationNs % 1000) / 100 << '}';
+        }
+    }
+    stream << "\n]}\n";
+
+    return stream.good();
+}
+
+/**
+ * Removes all recorded events. This must not be called while a search is running.
+ *
+ */
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for (const std::shared_ptr<ThreadBuffer>& buffer : registry().buffers)
+        buffer->recorded.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Public constructor. Starts to measure the scope.
+ *
+ * \param name The name of the scope. Has to live until the trace is written, usually a string literal.
+ * \param depth The depth of the tree the scope belongs to. -1 takes the depth of the enclosing scope.
+ */
+TraceScope::TraceScope(const char* name, int depth) : m_name(name), m_previousDepth(t_currentDepth)
+{
+    m_depth = depth >= 0 ? depth : t_currentDepth;
+    t_currentDepth = m_depth;
+    m_startNs = Trace::now();
+}
+
+/**
+ * Destructor. Records the scope.
+ *
+ */
+TraceScope::~TraceScope()
+{
+    Trace::record(m_name, m_startNs, Trace::now() - m_startNs, m_depth);
+    t_currentDepth = m_previousDepth;
+}
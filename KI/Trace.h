@@ -0,0 +1,73 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "CustomDefines.h"
+
+// Timeline profiling of the search. Scopes marked with TRACE_SCOPE are recorded into a ring buffer per thread and can
+// be written as Chrome trace JSON, which can be opened with about:tracing or https://ui.perfetto.dev. Every thread gets
+// its own process lane in the viewer and every tree depth its own thread lane inside of it. A thread that starts after
+// another one ended takes over its buffer and lane, so only threads that record at the same time need a buffer each.
+//
+// Tracing is compiled out unless KI_TRACE is defined, so the scopes cost nothing in normal builds.
+#ifdef KI_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Records the rest of the enclosing block. Uses the depth of the enclosing TRACE_SCOPE_DEPTH.
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, -1)
+// Records the rest of the enclosing block at the given depth of the tree.
+#define TRACE_SCOPE_DEPTH(name, depth) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, depth)
+#else
+#define TRACE_SCOPE(name) do { } while (0)
+#define TRACE_SCOPE_DEPTH(name, depth) do { UNUSED(depth); } while (0)
+#endif
+
+// Number of events every buffer keeps. Older events are overwritten.
+constexpr size_t TRACE_BUFFER_SIZE = size_t(1) << 18;
+
+class Trace
+{
+public:
+    struct Event
+    {
+        const char*     name;
+        int64_t         startNs;
+        int64_t         durationNs;
+        int             depth;
+    };
+
+    static constexpr bool isEnabled()
+    {
+#ifdef KI_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void record(const char* name, int64_t startNs, int64_t durationNs, int depth);
+    static int64_t now();
+    static bool writeChromeJson(const std::string& path);
+    static void clear();
+};
+
+// Records the time between its construction and destruction, see TRACE_SCOPE.
+class TraceScope
+{
+public:
+    TraceScope(const char* name, int depth);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char*     m_name;
+    int64_t         m_startNs;
+    int             m_depth;
+    int             m_previousDepth;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#include "TranspositionTable.h"
+
+/**
+ * Helper function to spread the packed keys, whose lower bits are mostly zero, over the whole table.
+ *
+ * \param key The key to hash.
+ * \return Returns the hashed key.
+ */
+static uint64_t hashKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+static_assert(sizeof(std::atomic<uint64_t>) * 2 == TRANSPOSITION_TABLE_ENTRY_BYTES, "Unexpected entry size");
+
+/**
+ * Helper function to unpack the depth of a stored entry.
+ *
+ * \param data The data of a slot.
+ * \return Returns the depth.
+ */
+static int unpackDepth(uint64_t data)
+{
+    return static_cast<int>((data >> 24) & 0xFF);
+}
+
+/**
+ * Public constructor.
+ *
+ * \param size The number of entries of the table. It is rounded down to a power of two.
+ */
+TranspositionTable::TranspositionTable(size_t size)
+{
+    size_t roundedSize = BUCKET_SIZE;
+    while (roundedSize * 2 <= size)
+        roundedSize *= 2;
+
+    m_slots.reset(new Slot[roundedSize]);
+    m_bucketMask = roundedSize / BUCKET_SIZE - 1;
+}
+
+/**
+ * Looks up a position. This method can be called from multiple threads at the same time.
+ *
+ * \param key The key of the position. See TRANSPOSITION_KEY_ALGORITHM_TO_MOVE.
+ * \param entry Receives the stored entry, if there is one.
+ * \return Returns true if the position was found.
+ */
+bool TranspositionTable::probe(uint64_t key, Entry& entry)
+{
+    Slot* bucket = &m_slots[(hashKey(key) & m_bucketMask) * BUCKET_SIZE];
+    for (size_t slotNr = 0; slotNr < BUCKET_SIZE; slotNr++)
+    {
+        uint64_t data = bucket[slotNr].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[slotNr].check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || data == 0)
+            continue;
+
+        // Layout: |value 32 bit|depth 8 bit|bound 8 bit|move 8 bit|unused 8 bit|
+        entry.value = static_cast<int32_t>(data >> 32);
+        entry.depth = unpackDepth(data);
+        entry.bound = static_cast<Bound>((data >> 16) & 0xFF);
+        entry.move = static_cast<int>((data >> 8) & 0xFF);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Stores a position. An older entry of the same position is replaced. Otherwise the entry goes to the first slot of
+ * its bucket if it was searched at least as deep as the entry there, else to the second slot. This method can be
+ * called from multiple threads at the same time.
+ *
+ * \param key The key of the position. See TRANSPOSITION_KEY_ALGORITHM_TO_MOVE.
+ * \param entry The entry to store.
+ */
+void TranspositionTable::store(uint64_t key, const Entry& entry)
+{
+    uint64_t data = (uint64_t(static_cast<uint32_t>(entry.value)) << 32)
+        | (uint64_t(entry.depth & 0xFF) << 24)
+        | (uint64_t(static_cast<uint8_t>(entry.bound)) << 16)
+        | (uint64_t(entry.move & 0xFF) << 8);
+
+    Slot* bucket = &m_slots[(hashKey(key) & m_bucketMask) * BUCKET_SIZE];
+    uint64_t firstData = bucket[0].data.load(std::memory_order_relaxed);
+    uint64_t firstCheck = bucket[0].check.load(std::memory_order_relaxed);
+    bool replaceFirst = (firstCheck ^ firstData) == key || unpackDepth(firstData) <= entry.depth;
+
+    Slot& slot = replaceFirst ? bucket[0] : bucket[1];
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+/**
+ * Removes all entries. This must not be called while other threads use the table.
+ *
+ */
+void TranspositionTable::clear()
+{
+    for (size_t index = 0; index < size(); index++)
+    {
+        m_slots[index].check.store(0, std::memory_order_relaxed);
+        m_slots[index].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Gives info about the size of the table.
+ *
+ * \return Returns the number of entries the table can hold.
+ */
+size_t TranspositionTable::size()
+{
+    return (m_bucketMask + 1) * BUCKET_SIZE;
+}
+
+/**
+ * Gives info about the number of entries that fit in a memory budget.
+ *
+ * \param megabytes The memory budget in MB.
+ * \return Returns the number of entries to pass to the constructor.
+ */
+size_t TranspositionTable::entriesForBudget(size_t megabytes)
+{
+    return megabytes * 1024 * 1024 / TRANSPOSITION_TABLE_ENTRY_BYTES;
+}
@@ -0,0 +1,61 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Default number of entries of a transposition table.
+constexpr size_t TRANSPOSITION_TABLE_DEFAULT_SIZE = size_t(1) << 20;
+constexpr size_t TRANSPOSITION_TABLE_ENTRY_BYTES = 16;
+
+// Bit that is added to a packed key if the algorithm is the next player. Packed keys only use the lower 49 bits.
+constexpr uint64_t TRANSPOSITION_KEY_ALGORITHM_TO_MOVE = uint64_t(1) << 63;
+
+class TranspositionTable
+{
+public:
+    enum class Bound : uint8_t
+    {
+        None,
+        Exact,
+        Lower,
+        Upper
+    };
+
+    struct Entry
+    {
+        int     value       = 0;
+        int     depth       = 0;
+        Bound   bound       = Bound::None;
+        int     move        = 0;
+    };
+
+    TranspositionTable(size_t size = TRANSPOSITION_TABLE_DEFAULT_SIZE);
+
+    bool probe(uint64_t key, Entry& entry);
+    void store(uint64_t key, const Entry& entry);
+    void clear();
+    size_t size();
+
+    static size_t entriesForBudget(size_t megabytes);
+
+private:
+    // Every slot stores the key xor'ed with the data. A slot that was torn by two threads writing at the same time
+    // will therefore not match any key and is treated as empty. This makes the table safe without any locks.
+    struct Slot
+    {
+        std::atomic<uint64_t> check{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+    };
+
+    // Every position can be stored in a bucket of two slots. The first slot keeps the deepest search, the second one
+    // takes everything else. When the table is full, shallow results are replaced first.
+    static constexpr size_t BUCKET_SIZE = 2;
+
+    std::unique_ptr<Slot[]>     m_slots;
+    size_t                      m_bucketMask;
+};
+
+#endif